@@ -0,0 +1,119 @@
+#ifndef AFINA_KEY_H
+#define AFINA_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace Afina {
+
+/**
+ * Hash function used for all keys: to select storage shard, to probe storage index and so on. Keep it in one
+ * place so that hash computed once for the key could be used everywhere. It works on raw bytes so keys could be
+ * hashed without being copied into std::string.
+ *
+ * If CPU has SSE4.2 that is hardware CRC32C of the key spread over 64 bits, otherwise that is MurmurHash64A.
+ * Hash is never stored anywhere, so it is fine that it depends on the build
+ */
+inline std::size_t KeyHash(const char *data, std::size_t size) {
+#if defined(__SSE4_2__)
+    uint64_t crc = ~uint32_t(size);
+    const char *end = data + (size & ~std::size_t(7));
+    for (; data != end; data += 8) {
+        uint64_t k;
+        std::memcpy(&k, data, sizeof(k));
+        crc = _mm_crc32_u64(crc, k);
+    }
+    if (size & 4) {
+        uint32_t k;
+        std::memcpy(&k, data, sizeof(k));
+        crc = _mm_crc32_u32(crc, k);
+        data += 4;
+    }
+    if (size & 2) {
+        uint16_t k;
+        std::memcpy(&k, data, sizeof(k));
+        crc = _mm_crc32_u16(crc, k);
+        data += 2;
+    }
+    if (size & 1) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+
+    // Indexes take tags from both low and high bits, so CRC is multiplied to get all of them depend on the key
+    uint64_t h = crc * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
+#else
+    const uint64_t m = 0xC6A4A7935BD1E995ULL;
+    const int r = 47;
+    uint64_t h = 0x8445D61A4E774912ULL ^ (size * m);
+
+    const char *end = data + (size & ~std::size_t(7));
+    for (; data != end; data += 8) {
+        uint64_t k;
+        std::memcpy(&k, data, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    switch (size & 7) {
+    case 7:
+        h ^= uint64_t(uint8_t(data[6])) << 48;
+    case 6:
+        h ^= uint64_t(uint8_t(data[5])) << 40;
+    case 5:
+        h ^= uint64_t(uint8_t(data[4])) << 32;
+    case 4:
+        h ^= uint64_t(uint8_t(data[3])) << 24;
+    case 3:
+        h ^= uint64_t(uint8_t(data[2])) << 16;
+    case 2:
+        h ^= uint64_t(uint8_t(data[1])) << 8;
+    case 1:
+        h ^= uint64_t(uint8_t(data[0]));
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+#endif
+}
+
+inline std::size_t KeyHash(const std::string &key) { return KeyHash(key.data(), key.size()); }
+
+/**
+ * # Key descriptor
+ * Refers to key bytes owned by somebody else and carries their hash. Descriptor is built once per request, so
+ * storage neither hashes the key again nor copies it unless the key is going to be stored.
+ *
+ * Bytes must stay unchanged while descriptor is in use
+ */
+struct Key {
+    Key(const char *data, std::size_t size, std::size_t hash) : data(data), size(size), hash(hash) {}
+    Key(const char *data, std::size_t size) : Key(data, size, KeyHash(data, size)) {}
+    explicit Key(const std::string &key) : Key(key.data(), key.size()) {}
+
+    bool operator==(const std::string &other) const {
+        return size == other.size() && std::memcmp(data, other.data(), size) == 0;
+    }
+
+    std::string str() const { return std::string(data, size); }
+
+    const char *data;
+    std::size_t size;
+    std::size_t hash;
+};
+
+} // namespace Afina
+
+#endif // AFINA_KEY_H
@@ -1,8 +1,15 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
 
+#include <afina/Key.h>
+
 namespace Afina {
 
 /**
@@ -10,6 +17,10 @@ namespace Afina {
  */
 class Storage {
 public:
+    // Immutable value buffer shared between storage and readers. Buffer stays valid and unchanged even if
+    // association gets updated or deleted, so it could be sent out without copy
+    using Value = std::shared_ptr<const std::string>;
+
     Storage() {}
     virtual ~Storage() {}
 
@@ -84,6 +95,254 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Same as Get, but gives out shared handle of the value instead of its copy. In case if given key not found
+     * method returns false and doesn't change the output parameter
+     *
+     * @param key to retrive value for
+     * @param value output parameter to put value handle to
+     */
+    virtual bool Get(const std::string &key, Value &value) {
+        std::string copy;
+        if (!Get(key, copy)) {
+            return false;
+        }
+        value = std::make_shared<const std::string>(std::move(copy));
+        return true;
+    }
+
+    /**
+     * Retrieves values for a batch of keys at once. For each i below count method puts handle of the value
+     * associated with keys[i] into values[i], or nullptr if there is no such association.
+     *
+     * Works as a sequence of Get calls, but allows storage to amortize locking and memory access costs
+     * over the batch. Returns number of keys found
+     *
+     * @param keys to retrieve values for
+     * @param count number of keys
+     * @param values output parameter, array of count handles
+     */
+    virtual std::size_t MultiGet(const std::string *keys, std::size_t count, Value *values) {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            values[i].reset();
+            result += Get(keys[i], values[i]);
+        }
+        return result;
+    }
+
+    /**
+     * Same as Get, but key comes together with its hash, see Key.h. Storage could reuse the hash instead of
+     * computing it again, by default key gets copied
+     *
+     * @param key descriptor of the key to retrive value for
+     * @param value output parameter to put value handle to
+     */
+    virtual bool Get(const Key &key, Value &value) { return Get(key.str(), value); }
+
+    /**
+     * Same as MultiGet above, but keys come together with their hashes, see Key.h
+     *
+     * @param keys descriptors of keys to retrieve values for
+     * @param count number of keys
+     * @param values output parameter, array of count handles
+     */
+    virtual std::size_t MultiGet(const Key *keys, std::size_t count, Value *values) {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            values[i].reset();
+            result += Get(keys[i], values[i]);
+        }
+        return result;
+    }
+
+    /**
+     * Same as Put, but association expires at the given time: once it comes storage behaves as if there is no
+     * association for the key. Time is a number of seconds since epoch, 0 means that association never expires.
+     * Put and PutIfAbsent without expiration time create associations which never expire, Set without it keeps
+     * expiration time of the existing association.
+     *
+     * Storage which doesn't support expiration keeps association until it gets evicted
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param expire time association expires at
+     */
+    virtual bool Put(const std::string &key, const std::string &value, uint32_t expire) { return Put(key, value); }
+
+    /**
+     * Same as Put above, but key comes together with its hash, see Key.h
+     */
+    virtual bool Put(const Key &key, const std::string &value, uint32_t expire) {
+        return Put(key.str(), value, expire);
+    }
+
+    /**
+     * Same as PutIfAbsent, but association expires at the given time, see Put above
+     */
+    virtual bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) {
+        return PutIfAbsent(key, value);
+    }
+
+    /**
+     * Same as Set, but association gets new expiration time, see Put above
+     */
+    virtual bool Set(const std::string &key, const std::string &value, uint32_t expire) { return Set(key, value); }
+
+    /**
+     * Atomically replaces value of the existing association by the one computed from it: update gets the current
+     * value and builds the new one. If update returns true the new value is stored keeping expiration time of the
+     * association, otherwise nothing changes. Returns true if the new value was stored.
+     *
+     * By default that is Get followed by Set, so storage which could be changed concurrently must override it
+     *
+     * @param key to update value for
+     * @param update callback getting the current value and building the new one, returns false to keep the current
+     */
+    virtual bool Update(const std::string &key,
+                        const std::function<bool(const std::string &value, std::string &result)> &update) {
+        std::string value, result;
+        if (!Get(key, value) || !update(value, result)) {
+            return false;
+        }
+        return Set(key, result);
+    }
+
+    /**
+     * Adds data to the end of the value of the existing association keeping its expiration time. Returns false
+     * if there is no association for the key or the result doesn't fit.
+     *
+     * Version gets the version of the extended association, see GetVersion below. It is given out by the same
+     * atomic step, so that is the version of this very write.
+     *
+     * By default that is Update building the whole new value and version is 0, storage could link data to the
+     * value instead. Storage which keeps versions must override it
+     *
+     * @param key association to extend
+     * @param data to be added after the value
+     * @param version output parameter to put the new version to
+     */
+    virtual bool Append(const std::string &key, const std::string &data, uint64_t &version) {
+        version = 0;
+        return Update(key, Extender(data, false));
+    }
+
+    /**
+     * Same as Append, but data is added before the value
+     */
+    virtual bool Prepend(const std::string &key, const std::string &data, uint64_t &version) {
+        version = 0;
+        return Update(key, Extender(data, true));
+    }
+
+    /**
+     * Same as Get, but association gets the new expiration time at once, see Put above. In case if given key not
+     * found method returns false and changes nothing. By default that is Get followed by Set
+     *
+     * @param key to retrive value for
+     * @param expire time association expires at
+     * @param value output parameter to put value handle to
+     */
+    virtual bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) {
+        Value current;
+        if (!Get(key, current) || !Set(key, *current, expire)) {
+            return false;
+        }
+        value = std::move(current);
+        return true;
+    }
+
+    /**
+     * Sets the new expiration time of the existing association without changing its value, see Put above.
+     * Returns false if there is no association for the key
+     *
+     * @param key association to touch
+     * @param expire time association expires at
+     */
+    virtual bool Touch(const std::string &key, uint32_t expire) {
+        Value value;
+        return GetAndTouch(key, expire, value);
+    }
+
+    /**
+     * Tells if storage keeps version of each association, see GetVersion and CompareAndSet below. Storage which
+     * doesn't can't do check and set, so gets and cas commands are refused for it
+     */
+    virtual bool Versioned() const { return false; }
+
+    /**
+     * Same as Get, but gives out version of the association as well. Version changes every time value of the
+     * association gets replaced, see CompareAndSet below.
+     *
+     * By default storage doesn't keep versions, so that is just Get giving out 0 version
+     *
+     * @param key to retrive value for
+     * @param value output parameter to put value handle to
+     * @param version output parameter to put version to, never 0 if storage is versioned
+     */
+    virtual bool GetVersion(const std::string &key, Value &value, uint64_t &version) {
+        if (!Get(key, value)) {
+            return false;
+        }
+        version = 0;
+        return true;
+    }
+
+    /**
+     * Same as Set, but only if association still has the given version: check and write are done atomically, so
+     * the value is replaced only if nobody changed it since it was read by GetVersion.
+     *
+     * Returns true if value was stored, version gets the new one. Otherwise version tells why: 0 if there is no
+     * association for the key, current version if it doesn't match, unchanged if value can't be stored.
+     *
+     * Storage which doesn't keep versions can't check them, so by default value is never stored and version stays
+     * unchanged
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param expire time association expires at, see Put above
+     * @param version input/output parameter, expected version of the association
+     */
+    virtual bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) {
+        return false;
+    }
+
+    /**
+     * Visits associations which keys start with the given prefix, in lexicographical order of keys, until visit
+     * returns false. Storage which doesn't keep keys ordered can't do that without full walk, so by default method
+     * returns false and never calls visit
+     *
+     * @param prefix keys should start with, empty one matches all keys
+     * @param visit callback getting key and value handle, returns false to stop the scan
+     */
+    virtual bool Scan(const std::string &prefix,
+                      const std::function<bool(const std::string &key, const Value &value)> &visit) {
+        return false;
+    }
+
+    /**
+     * Reports storage specific statistics, such as hit/miss counters, as a set of name/value pairs. They are
+     * sent back to client by the stats command. By default storage has nothing to report
+     *
+     * @param stats output parameter to add statistics to
+     */
+    virtual void Stats(std::map<std::string, std::string> &stats) {}
+
+protected:
+    // Update callback of Append and Prepend, data is added before the value if head is set and after it otherwise
+    static std::function<bool(const std::string &value, std::string &result)> Extender(const std::string &data,
+                                                                                       bool head) {
+        return [&data, head](const std::string &value, std::string &result) {
+            result.reserve(value.size() + data.size());
+            if (head) {
+                result.append(data).append(value);
+            } else {
+                result.append(value).append(data);
+            }
+            return true;
+        };
+    }
 };
 
 } // namespace Afina
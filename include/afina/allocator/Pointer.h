@@ -7,6 +7,11 @@ namespace Allocator {
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * Handle of the memory block allocated by Simple. Allocator could move block during defragmentation, so
+ * pointer refers to the allocator's descriptor which knows current block location. Copies of the pointer
+ * refer to the same block
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +22,15 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const { return _desc == nullptr ? nullptr : *_desc; }
+
+private:
+    friend class Simple;
+
+    explicit Pointer(void **desc) : _desc(desc) {}
+
+    // Descriptor slot inside of the allocator memory, nullptr if pointer refers to nothing
+    void **_desc;
 };
 
 } // namespace Allocator
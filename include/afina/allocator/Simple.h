@@ -1,8 +1,8 @@
 #ifndef AFINA_ALLOCATOR_SIMPLE_H
 #define AFINA_ALLOCATOR_SIMPLE_H
 
-#include <string>
 #include <cstddef>
+#include <string>
 
 namespace Afina {
 namespace Allocator {
@@ -18,6 +18,10 @@ class Pointer;
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * Memory layout: blocks, each one has a header, grow from the beginning of the area. Table of descriptors,
+ * one per allocated block, grows from the end of the area. Pointer refers to the descriptor, so block could
+ * be moved by defrag without pointers update.
  */
 // TODO: Implements interface to allow usage as C++ allocators
 class Simple {
@@ -25,37 +29,72 @@ public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates block of at least N bytes. Throws AllocError(NoMemory) if there is no
+     * continuous free space of such size, even if there is enough space in total.
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Changes size of the block, keeping its content. Block grows in place if there is
+     * free space right after it, otherwise it gets moved. Null pointer is allocated from scratch.
+     * Throws AllocError(NoMemory) if there is no space, pointer stays valid in this case.
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Releases block the pointer refers to and resets the pointer. Throws AllocError(InvalidFree) if
+     * pointer doesn't belong to this allocator
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Moves all allocated blocks to the beginning of the area, so that all free space
+     * becomes continuous
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Returns human readable description of blocks and free space
      */
     std::string dump() const;
 
 private:
+    // Block header
+    struct block;
+
+    // Returns block for the given descriptor, checks descriptor is valid
+    block *Owner(void **desc) const;
+
+    // Takes free descriptor, throws NoMemory if there is no space for the new one
+    void **TakeDescriptor();
+
+    // Puts descriptor back to the free list
+    void ReleaseDescriptor(void **desc);
+
+    // First fit free block of at least given size, merges neighbour free blocks on the way
+    block *FindFree(size_t size);
+
+    // Merges free blocks right after the given one into it
+    void Absorb(block *b);
+
+    // Cuts the tail of the block into a separate free block if it is big enough
+    void Split(block *b, size_t size);
+
     void *_base;
     const size_t _base_len;
+
+    // Area of blocks is [_begin, _top), area of descriptors is [_desc, _end)
+    char *_begin;
+    char *_top;
+    void **_desc;
+    void **_end;
+
+    // List of free descriptors, linked through descriptors themselves
+    void **_free_desc;
 };
 
 } // namespace Allocator
@@ -0,0 +1,160 @@
+#ifndef AFINA_ALLOCATOR_SLAB_H
+#define AFINA_ALLOCATOR_SLAB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include <afina/allocator/Pointer.h>
+
+namespace Afina {
+namespace Allocator {
+
+// Forward declaration. Do not include real class definition
+// to avoid expensive macros calculations and increase compile speed
+class Simple;
+
+/**
+ * # Slab allocator
+ * Carves fixed size chunks out of pages taken from Simple allocator. Chunk sizes form a geometric sequence,
+ * every request is served by the smallest class it fits in, so memory lost for rounding is bounded by the growth
+ * factor and freed chunks are reused by objects of similar size without fragmentation of the underlying area.
+ * Requests bigger than the largest class get dedicated block from Simple.
+ *
+ * Returned memory never moves, so defrag must never be called on the underlying allocator. Page gets back to
+ * Simple once all its chunks are free, except for the last page of the class which is kept to avoid thrashing.
+ * Instead of going back to Simple, empty page could be handed over to another class, see Move.
+ *
+ * That is NOT thread safe implementation!!
+ */
+class Slab {
+public:
+    // Utilization of the single size class
+    struct class_stats {
+        std::size_t chunk_size;
+        std::size_t pages;
+        std::size_t used_chunks;
+        std::size_t total_chunks;
+    };
+
+    /**
+     * @param memory allocator pages are taken from
+     * @param page_size size of the single page
+     * @param min_chunk size of the smallest chunk
+     * @param factor ratio of the sizes of the neighbour classes
+     */
+    Slab(Simple &memory, std::size_t page_size, std::size_t min_chunk = 32, double factor = 1.25);
+    ~Slab();
+
+    /**
+     * Allocates chunk of at least given size. Throws AllocError(NoMemory) if there is no free chunk in the class
+     * and underlying allocator has no space for the new page
+     */
+    void *alloc(std::size_t size);
+
+    /**
+     * Releases chunk, throws AllocError(InvalidFree) if it doesn't belong to this allocator
+     */
+    void free(void *ptr);
+
+    /**
+     * Number of bytes actually consumed by allocation of the given size
+     */
+    std::size_t ChunkSize(std::size_t size) const;
+
+    /**
+     * Index of the class serving allocation of the given size, number of classes if it is too big for any
+     */
+    std::size_t ClassOf(std::size_t size) const;
+
+    /**
+     * Hands page of the class from over to the class to. If from has an empty page it is moved right away and
+     * true is returned, otherwise the first page of from which gets empty is moved and Moving(from) is true
+     * until then. Caller is expected to free chunks of from to make that happen
+     */
+    bool Move(std::size_t from, std::size_t to);
+
+    // Number of pages owned by the class
+    std::size_t Pages(std::size_t klass) const { return _classes[klass].pages; }
+
+    // Checks if class waits for one of its pages to get empty to move it
+    bool Moving(std::size_t klass) const { return _classes[klass].move_to != kNoMove; }
+
+    /**
+     * Utilization of all size classes
+     */
+    std::vector<class_stats> Classes() const;
+
+    // Number and total size of allocations which are too big for any class
+    std::size_t LargeCount() const { return _large_count; }
+    std::size_t LargeBytes() const { return _large_bytes; }
+
+    // Number of bytes taken from the underlying allocator
+    std::size_t Footprint() const { return _footprint; }
+
+    // Number of pages handed over between classes
+    std::size_t MovedPages() const { return _moved_pages; }
+
+private:
+    static constexpr std::size_t kNoMove = SIZE_MAX;
+
+    // Page of chunks or dedicated block of large allocation
+    struct page {
+        Pointer block;
+        std::size_t size;
+        std::size_t klass;
+
+        // Free chunks of the page linked through chunks themselves, and beginning of never used space
+        void *free;
+        char *fresh;
+        std::size_t used;
+
+        // List of pages of the same class having free chunks
+        page *prev;
+        page *next;
+    };
+
+    // Size class
+    struct size_class {
+        std::size_t chunk_size;
+        std::size_t per_page;
+        std::size_t pages;
+        std::size_t used;
+
+        // Pages having free chunks
+        page *partial;
+
+        // Class the next empty page goes to, kNoMove if page is kept
+        std::size_t move_to;
+    };
+
+    // Takes new page for the class from the underlying allocator
+    page &NewPage(std::size_t klass, std::size_t size);
+
+    // Returns page back to the underlying allocator
+    void ReleasePage(std::map<char *, page>::iterator it);
+
+    // Carves empty page for the chunks of the other class
+    void MovePage(page &p, std::size_t klass);
+
+    void LinkPartial(size_class &cls, page &p);
+    void UnlinkPartial(size_class &cls, page &p);
+
+    Simple &_memory;
+    const std::size_t _page_size;
+    std::vector<size_class> _classes;
+
+    // All pages by their beginning, so chunk could find its page
+    std::map<char *, page> _pages;
+
+    std::size_t _large_count;
+    std::size_t _large_bytes;
+    std::size_t _footprint;
+    std::size_t _moved_pages;
+};
+
+} // namespace Allocator
+} // namespace Afina
+
+#endif // AFINA_ALLOCATOR_SLAB_H
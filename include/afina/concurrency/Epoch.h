@@ -0,0 +1,59 @@
+#ifndef AFINA_CONCURRENCY_EPOCH_H
+#define AFINA_CONCURRENCY_EPOCH_H
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Epoch based memory reclamation
+ * Allows lock-free readers to traverse shared structures while writers unlink and retire parts of them. Reader
+ * accesses shared memory only inside of critical section (see Guard below), retired object is deleted once every
+ * thread has left critical sections it could see the object in.
+ *
+ * There is the global epoch counter. Thread entering critical section announces epoch it observed, epoch is
+ * advanced only when all threads inside of critical sections have announced the current one. Object retired in
+ * epoch E is not reachable for threads entered at E + 1, so it is safe to delete once epoch reaches E + 2.
+ *
+ * Each thread keeps its own list of retired objects, so retiring is cheap and doesn't need synchronization.
+ * Objects left by exited thread are taken over by the next thread collecting garbage.
+ */
+class Epoch {
+public:
+    /**
+     * RAII critical section, could be nested
+     */
+    class Guard {
+    public:
+        Guard() { Enter(); }
+        ~Guard() { Exit(); }
+
+    private:
+        Guard(const Guard &);            // = delete;
+        Guard &operator=(const Guard &); // = delete;
+    };
+
+    // Starts critical section of the current thread
+    static void Enter();
+
+    // Finishes critical section of the current thread
+    static void Exit();
+
+    /**
+     * Schedules object deletion once no thread could access it. Object must be unreachable for threads entering
+     * critical section after this call
+     */
+    template <typename T> static void Retire(T *ptr) {
+        Retire(ptr, [](void *p) { delete static_cast<T *>(p); });
+    }
+    static void Retire(void *ptr, void (*deleter)(void *));
+
+    /**
+     * Tries to advance epoch and deletes objects retired by the current thread which are safe to delete
+     */
+    static void Collect();
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_EPOCH_H
@@ -0,0 +1,61 @@
+#ifndef AFINA_CONCURRENCY_SHARED_MUTEX_H
+#define AFINA_CONCURRENCY_SHARED_MUTEX_H
+
+#include <stdexcept>
+
+#include <pthread.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Readers-writer lock
+ * Mutex supporting both unique (write) and shared (read) ownership. Could be used with std::unique_lock for
+ * exclusive ownership and with SharedLock below for the shared one
+ */
+class SharedMutex {
+public:
+    SharedMutex() {
+        if (pthread_rwlock_init(&_lock, nullptr) != 0) {
+            throw std::runtime_error("Failed to create rwlock");
+        }
+    }
+    ~SharedMutex() { pthread_rwlock_destroy(&_lock); }
+
+    // Exclusive ownership
+    void lock() { pthread_rwlock_wrlock(&_lock); }
+    bool try_lock() { return pthread_rwlock_trywrlock(&_lock) == 0; }
+    void unlock() { pthread_rwlock_unlock(&_lock); }
+
+    // Shared ownership
+    void lock_shared() { pthread_rwlock_rdlock(&_lock); }
+    bool try_lock_shared() { return pthread_rwlock_tryrdlock(&_lock) == 0; }
+    void unlock_shared() { pthread_rwlock_unlock(&_lock); }
+
+private:
+    // No copy/move/assign allowed
+    SharedMutex(const SharedMutex &);            // = delete;
+    SharedMutex &operator=(const SharedMutex &); // = delete;
+
+    pthread_rwlock_t _lock;
+};
+
+/**
+ * RAII wrapper to hold shared ownership of the mutex in a scope
+ */
+template <typename Mutex> class SharedLock {
+public:
+    explicit SharedLock(Mutex &mutex) : _mutex(mutex) { _mutex.lock_shared(); }
+    ~SharedLock() { _mutex.unlock_shared(); }
+
+private:
+    SharedLock(const SharedLock &);            // = delete;
+    SharedLock &operator=(const SharedLock &); // = delete;
+
+    Mutex &_mutex;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SHARED_MUTEX_H
@@ -0,0 +1,45 @@
+#ifndef AFINA_EXECUTE_ARITHMETIC_COMMAND_H
+#define AFINA_EXECUTE_ARITHMETIC_COMMAND_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Basic class for incr/decr commands
+ * Item value must be a decimal representation of 64-bit unsigned integer. Value is changed in place by a single
+ * storage update, so concurrent commands on the same key never lose each other changes. Item keeps its expiration
+ * time.
+ *
+ * Command must write result to the output, which could be:
+ * - new value of the item, to indicate success
+ * - "NOT_FOUND" to indicate that the item with this key was not found
+ * - "CLIENT_ERROR cannot increment or decrement non-numeric value" if value isn't a number
+ */
+class ArithmeticCommand : public Command {
+public:
+    ArithmeticCommand(std::string key, uint64_t delta) : _key(std::move(key)), _delta(delta) {}
+    ~ArithmeticCommand() {}
+
+    inline const std::string &key() const { return _key; }
+    inline uint64_t delta() const { return _delta; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+protected:
+    // New value of the item given the current one
+    virtual uint64_t Apply(uint64_t value) const = 0;
+
+    const std::string _key;
+    const uint64_t _delta;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_ARITHMETIC_COMMAND_H
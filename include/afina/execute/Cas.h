@@ -0,0 +1,41 @@
+#ifndef AFINA_EXECUTE_CAS_H
+#define AFINA_EXECUTE_CAS_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "InsertCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Check and set
+ * Store this data but only if no one else has updated since I last fetched it: version of the item must still
+ * be the one given out by gets. Check and write are done atomically by the storage
+ *
+ * Command must write result to the output, which could be:
+ * - "STORED", to indicate success.
+ * - "NOT_STORED" to indicate the data was not stored, because it doesn't fit into the storage
+ * - "EXISTS" to indicate that the item you are trying to store has been modified since you last fetched it
+ * - "NOT_FOUND" to indicate that the item did not exist, or has been deleted
+ */
+class Cas : public InsertCommand {
+public:
+    Cas(std::string key, uint32_t flags, int32_t expire, uint64_t version)
+        : InsertCommand(std::move(key), flags, expire), _version(version) {}
+    ~Cas() {}
+
+    inline uint64_t version() const { return _version; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+private:
+    const uint64_t _version;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_CAS_H
@@ -1,8 +1,11 @@
 #ifndef AFINA_EXECUTE_COMMAND_H
 #define AFINA_EXECUTE_COMMAND_H
 
+#include <cstdint>
 #include <string>
 
+#include "Response.h"
+
 namespace Afina {
 
 class Storage;
@@ -19,6 +22,21 @@ public:
     virtual ~Command() {}
 
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Same as above, but response could refer to storage memory instead of copying it. By default response
+     * is the single text buffer
+     */
+    virtual void Execute(Storage &storage, const std::string &args, Response &out) {
+        std::string text;
+        Execute(storage, args, text);
+        out.Append(std::move(text));
+    }
+
+protected:
+    // Expiration time in seconds since epoch as storage expects it, 0 if item never expires. Protocol allows
+    // expire to be either relative number of seconds up to 30 days or absolute time
+    static uint32_t Deadline(int32_t expire);
 };
 
 } // namespace Execute
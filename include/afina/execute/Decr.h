@@ -0,0 +1,30 @@
+#ifndef AFINA_EXECUTE_DECR_H
+#define AFINA_EXECUTE_DECR_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "ArithmeticCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Decrement value of the key
+ * Subtracts delta from the numeric value of the existing item, value never goes below 0. See ArithmeticCommand
+ * for the output
+ */
+class Decr : public ArithmeticCommand {
+public:
+    Decr(std::string key, uint64_t delta) : ArithmeticCommand(std::move(key), delta) {}
+    ~Decr() {}
+
+protected:
+    uint64_t Apply(uint64_t value) const override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_DECR_H
@@ -0,0 +1,37 @@
+#ifndef AFINA_EXECUTE_ERROR_H
+#define AFINA_EXECUTE_ERROR_H
+
+#include <string>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Reply to the bad command line
+ * Parser gives that command out instead of the one it failed to parse, so error is reported the same way as any
+ * other reply and the following commands keep being served. Command doesn't touch the storage
+ *
+ * Command writes the given reply to the output, which could be:
+ * - "ERROR" means the client sent a nonexistent command name.
+ * - "CLIENT_ERROR <error>" means some sort of client error in the input line, i.e. the input doesn't conform
+ * to the protocol in some way.
+ */
+class Error : public Command {
+public:
+    Error(const char *reply) : _reply(reply) {}
+    ~Error() {}
+
+    inline const char *reply() const { return _reply; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+private:
+    const char *_reply;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_ERROR_H
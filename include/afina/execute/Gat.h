@@ -0,0 +1,42 @@
+#ifndef AFINA_EXECUTE_GAT_H
+#define AFINA_EXECUTE_GAT_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Retrieve values and update expiration time
+ * Same as Get, but each item found gets the new expiration time at once. Response looks exactly like the Get one:
+ * VALUE <key> <flags> <bytes>\r\n
+ * <data>\r\n
+ * VALUE ....
+ * END
+ */
+class Gat : public Command {
+public:
+    Gat(int32_t expire, std::vector<std::string> keys) : _expire(expire), _keys(std::move(keys)) {}
+    ~Gat() {}
+
+    inline int32_t expire() const { return _expire; }
+    inline const std::vector<std::string> &keys() const { return _keys; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+private:
+    const int32_t _expire;
+    std::vector<std::string> _keys;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_GAT_H
@@ -2,6 +2,7 @@
 #define AFINA_EXECUTE_GET_H
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Command.h"
@@ -34,13 +35,15 @@ namespace Execute {
  */
 class Get : public Command {
 public:
-    Get(const std::vector<std::string> &keys) : _keys(keys) {}
+    Get(std::vector<std::string> keys) : _keys(std::move(keys)) {}
     ~Get() {}
 
     inline const std::vector<std::string> &keys() const { return _keys; }
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
 private:
     std::vector<std::string> _keys;
 };
@@ -0,0 +1,39 @@
+#ifndef AFINA_EXECUTE_GETS_H
+#define AFINA_EXECUTE_GETS_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Retrive values with their versions
+ * Same as Get, but each item carries its version, which could be passed to the cas command later:
+ * VALUE <key> <flags> <bytes> <cas unique>\r\n
+ * <data>\r\n
+ * VALUE ....
+ * END
+ */
+class Gets : public Command {
+public:
+    Gets(std::vector<std::string> keys) : _keys(std::move(keys)) {}
+    ~Gets() {}
+
+    inline const std::vector<std::string> &keys() const { return _keys; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+private:
+    std::vector<std::string> _keys;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_GETS_H
@@ -0,0 +1,30 @@
+#ifndef AFINA_EXECUTE_INCR_H
+#define AFINA_EXECUTE_INCR_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "ArithmeticCommand.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Increment value of the key
+ * Adds delta to the numeric value of the existing item, overflow wraps around 64 bits. See ArithmeticCommand for
+ * the output
+ */
+class Incr : public ArithmeticCommand {
+public:
+    Incr(std::string key, uint64_t delta) : ArithmeticCommand(std::move(key), delta) {}
+    ~Incr() {}
+
+protected:
+    uint64_t Apply(uint64_t value) const override;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_INCR_H
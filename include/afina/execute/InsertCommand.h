@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "Command.h"
 
@@ -15,7 +16,8 @@ namespace Execute {
  */
 class InsertCommand : public Command {
 public:
-    InsertCommand(const std::string &key, uint32_t flags, int32_t expire) : _key(key), _flags(flags), _expire(expire) {}
+    InsertCommand(std::string key, uint32_t flags, int32_t expire)
+        : _key(std::move(key)), _flags(flags), _expire(expire) {}
     ~InsertCommand() {}
 
     inline const std::string &key() const { return _key; }
@@ -23,6 +25,9 @@ public:
     inline const int32_t expire() const { return _expire; }
 
 protected:
+    // Expiration time of the item being inserted, see Command.h
+    uint32_t Deadline() const { return Command::Deadline(_expire); }
+
     const std::string _key;
     const uint32_t _flags;
     const int32_t _expire;
@@ -0,0 +1,50 @@
+#ifndef AFINA_EXECUTE_KEYS_H
+#define AFINA_EXECUTE_KEYS_H
+
+#include <cstddef>
+#include <string>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # List keys by prefix
+ * Admin command, lists keys starting with the given prefix in lexicographical order. Empty prefix lists all
+ * keys. Each key sent by the server looks like this:
+ * KEY <key>
+ * KEY ....
+ * END
+ *
+ * Response is built of buffers of about kBatchSize bytes, so no single buffer grows with the keyspace. At most
+ * kMaxKeys keys are listed, if there are more of them the line "TRUNCATED" goes right before END and client could
+ * narrow the prefix.
+ *
+ * Storage which doesn't keep keys ordered responds by
+ * "SERVER_ERROR keys scan is not supported by storage"
+ */
+class Keys : public Command {
+public:
+    // Limit of keys listed by single command
+    static constexpr std::size_t kMaxKeys = 10000;
+
+    // Size response buffer gets sealed at
+    static constexpr std::size_t kBatchSize = 16 * 1024;
+
+    Keys(const std::string &prefix) : _prefix(prefix) {}
+    ~Keys() {}
+
+    inline const std::string &prefix() const { return _prefix; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+private:
+    std::string _prefix;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_KEYS_H
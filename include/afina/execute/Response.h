@@ -0,0 +1,56 @@
+#ifndef AFINA_EXECUTE_RESPONSE_H
+#define AFINA_EXECUTE_RESPONSE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/uio.h>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Command response
+ * Sequence of buffers to be sent to the client one after another. Buffer is either a piece of text owned by
+ * the response or a shared value buffer owned by the storage, the latter are never copied, network layer
+ * sends them right from the storage memory with a single gathering write.
+ */
+class Response {
+public:
+    Response() : _size(0) {}
+
+    // Appends text owned by the response
+    void Append(std::string text);
+
+    // Appends shared buffer, response holds a reference so buffer stays alive until response is sent
+    void Append(std::shared_ptr<const std::string> buffer);
+
+    // Total number of bytes
+    std::size_t Size() const { return _size; }
+
+    /**
+     * Adds descriptors of all buffers to the given vector. Descriptors are valid while response isn't changed
+     */
+    void Gather(std::vector<struct iovec> &iov) const;
+
+    // Concatenation of all buffers
+    std::string str() const;
+
+private:
+    // Either text or shared buffer is used
+    struct part {
+        std::string text;
+        std::shared_ptr<const std::string> buffer;
+
+        const std::string &data() const { return buffer ? *buffer : text; }
+    };
+
+    std::vector<part> _parts;
+    std::size_t _size;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_RESPONSE_H
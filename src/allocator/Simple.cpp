@@ -1,40 +1,244 @@
 #include <afina/allocator/Simple.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
+// All blocks are aligned to that value
+static const size_t kAlign = 16;
+
+// Block header, data follows it right away
+struct Simple::block {
+    // Size of the data, excluding header
+    size_t size;
+
+    // Descriptor of the allocated block, nullptr for the free one
+    void **desc;
+
+    char *data() { return reinterpret_cast<char *>(this + 1); }
+    block *next() { return reinterpret_cast<block *>(data() + size); }
+};
+
+static size_t Round(size_t n) { return (std::max<size_t>(n, 1) + kAlign - 1) & ~(kAlign - 1); }
+
+Simple::Simple(void *base, size_t size) : _base(base), _base_len(size), _free_desc(nullptr) {
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(base) + kAlign - 1) & ~(kAlign - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(base) + size) & ~(sizeof(void *) - 1);
+
+    _begin = _top = reinterpret_cast<char *>(begin);
+    _desc = _end = reinterpret_cast<void **>(std::max(begin, end));
+}
 
 /**
- * TODO: semantics
+ * Allocates block: first fit among free blocks, then free space at the top
  * @param N size_t
  */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
+Pointer Simple::alloc(size_t N) {
+    size_t size = Round(N);
+    void **desc = TakeDescriptor();
+
+    block *b = FindFree(size);
+    if (b == nullptr) {
+        if (size_t(reinterpret_cast<char *>(_desc) - _top) < sizeof(block) + size) {
+            ReleaseDescriptor(desc);
+            throw AllocError(AllocErrorType::NoMemory, "Not enough continuous memory");
+        }
+        b = reinterpret_cast<block *>(_top);
+        b->size = size;
+        _top = reinterpret_cast<char *>(b->next());
+    } else {
+        Split(b, size);
+    }
+
+    b->desc = desc;
+    *desc = b->data();
+    return Pointer(desc);
+}
 
 /**
- * TODO: semantics
+ * Resizes block in place if possible, otherwise moves it keeping the same descriptor
  * @param p Pointer
  * @param N size_t
  */
-void Simple::realloc(Pointer &p, size_t N) {}
+void Simple::realloc(Pointer &p, size_t N) {
+    if (p._desc == nullptr) {
+        p = alloc(N);
+        return;
+    }
+
+    block *b = Owner(p._desc);
+    size_t size = Round(N);
+    if (size > b->size) {
+        Absorb(b);
+
+        // Last block could grow into the free space at the top
+        if (reinterpret_cast<char *>(b->next()) == _top &&
+            size_t(reinterpret_cast<char *>(_desc) - b->data()) >= size) {
+            b->size = size;
+            _top = b->data() + size;
+            return;
+        }
+    }
+
+    if (size <= b->size) {
+        Split(b, size);
+        return;
+    }
+
+    Pointer moved = alloc(N);
+    block *nb = Owner(moved._desc);
+    std::memcpy(nb->data(), b->data(), b->size);
+
+    // Swap descriptors, so that all copies of p refer to the new block, and release the old one
+    nb->desc = p._desc;
+    *p._desc = nb->data();
+    b->desc = moved._desc;
+    *moved._desc = b->data();
+    free(moved);
+}
 
 /**
- * TODO: semantics
+ * Marks block as free and gives descriptor back
  * @param p Pointer
  */
-void Simple::free(Pointer &p) {}
+void Simple::free(Pointer &p) {
+    block *b = Owner(p._desc);
+    b->desc = nullptr;
+    ReleaseDescriptor(p._desc);
+    p._desc = nullptr;
+
+    Absorb(b);
+    if (reinterpret_cast<char *>(b->next()) == _top) {
+        _top = reinterpret_cast<char *>(b);
+    }
+}
 
 /**
- * TODO: semantics
+ * Compacts all allocated blocks to the beginning
  */
-void Simple::defrag() {}
+void Simple::defrag() {
+    char *dst = _begin;
+    for (char *cur = _begin; cur < _top;) {
+        block *b = reinterpret_cast<block *>(cur);
+        size_t total = sizeof(block) + b->size;
+        if (b->desc != nullptr) {
+            if (cur != dst) {
+                std::memmove(dst, cur, total);
+                b = reinterpret_cast<block *>(dst);
+                *b->desc = b->data();
+            }
+            dst += total;
+        }
+        cur += total;
+    }
+    _top = dst;
+}
 
 /**
- * TODO: semantics
+ * One line per block and summary of free space
  */
-std::string Simple::dump() const { return ""; }
+std::string Simple::dump() const {
+    std::stringstream out;
+    size_t used = 0, free = 0;
+    for (char *cur = _begin; cur < _top;) {
+        block *b = reinterpret_cast<block *>(cur);
+        out << (b->desc != nullptr ? "used " : "free ") << (cur - _begin) << " " << b->size << std::endl;
+        (b->desc != nullptr ? used : free) += b->size;
+        cur = b->data() + b->size;
+    }
+    out << "used: " << used << ", free: " << free
+        << ", top: " << (reinterpret_cast<char *>(_desc) - _top) << ", descriptors: " << (_end - _desc) << std::endl;
+    return out.str();
+}
+
+// See Simple.h
+Simple::block *Simple::Owner(void **desc) const {
+    if (desc == nullptr || desc < _desc || desc >= _end) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to allocator");
+    }
+
+    char *data = static_cast<char *>(*desc);
+    if (data < _begin + sizeof(block) || data > _top) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer refers to released block");
+    }
+
+    block *b = reinterpret_cast<block *>(data) - 1;
+    if (b->desc != desc) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer refers to released block");
+    }
+    return b;
+}
+
+// See Simple.h
+void **Simple::TakeDescriptor() {
+    if (_free_desc != nullptr) {
+        void **desc = _free_desc;
+        _free_desc = static_cast<void **>(*desc);
+        return desc;
+    }
+
+    if (size_t(reinterpret_cast<char *>(_desc) - _top) < sizeof(void *)) {
+        throw AllocError(AllocErrorType::NoMemory, "No memory for descriptor");
+    }
+    return --_desc;
+}
+
+// See Simple.h
+void Simple::ReleaseDescriptor(void **desc) {
+    *desc = _free_desc;
+    _free_desc = desc;
+}
+
+// See Simple.h
+Simple::block *Simple::FindFree(size_t size) {
+    for (block *b = reinterpret_cast<block *>(_begin); reinterpret_cast<char *>(b) < _top; b = b->next()) {
+        if (b->desc != nullptr) {
+            continue;
+        }
+
+        Absorb(b);
+        if (reinterpret_cast<char *>(b->next()) == _top) {
+            // Trailing free block is given back to the top
+            _top = reinterpret_cast<char *>(b);
+            return nullptr;
+        }
+        if (b->size >= size) {
+            return b;
+        }
+    }
+    return nullptr;
+}
+
+// See Simple.h
+void Simple::Absorb(block *b) {
+    for (block *n = b->next(); reinterpret_cast<char *>(n) < _top && n->desc == nullptr; n = b->next()) {
+        b->size += sizeof(block) + n->size;
+    }
+}
+
+// See Simple.h
+void Simple::Split(block *b, size_t size) {
+    if (b->size < size + sizeof(block) + kAlign) {
+        return;
+    }
+
+    block *rest = reinterpret_cast<block *>(b->data() + size);
+    rest->size = b->size - size - sizeof(block);
+    rest->desc = nullptr;
+    b->size = size;
+
+    Absorb(rest);
+    if (reinterpret_cast<char *>(rest->next()) == _top) {
+        _top = reinterpret_cast<char *>(rest);
+    }
+}
 
 } // namespace Allocator
 } // namespace Afina
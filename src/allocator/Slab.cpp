@@ -0,0 +1,228 @@
+#include <afina/allocator/Slab.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Simple.h>
+
+namespace Afina {
+namespace Allocator {
+
+// Chunk sizes are multiples of that value, so chunks are aligned for any header
+static const std::size_t kChunkAlign = 8;
+
+constexpr std::size_t Slab::kNoMove;
+
+static std::size_t AlignChunk(std::size_t n) { return (n + kChunkAlign - 1) & ~(kChunkAlign - 1); }
+
+Slab::Slab(Simple &memory, std::size_t page_size, std::size_t min_chunk, double factor)
+    : _memory(memory), _page_size(page_size), _large_count(0), _large_bytes(0), _footprint(0),
+      _moved_pages(0) {
+    // Chunk must be able to hold free list link
+    std::size_t size = AlignChunk(std::max(min_chunk, sizeof(void *)));
+
+    // Class bigger than half of the page would waste too much on the page tail
+    while (size <= _page_size / 2) {
+        _classes.push_back(size_class{size, _page_size / size, 0, 0, nullptr, kNoMove});
+        size = AlignChunk(std::max<std::size_t>(size + 1, size * factor));
+    }
+}
+
+Slab::~Slab() {
+    while (!_pages.empty()) {
+        ReleasePage(_pages.begin());
+    }
+}
+
+// See Slab.h
+void *Slab::alloc(std::size_t size) {
+    std::size_t klass = ClassOf(size);
+    if (klass == _classes.size()) {
+        page &p = NewPage(klass, size);
+        _large_count++;
+        _large_bytes += size;
+        return p.block.get();
+    }
+
+    size_class &cls = _classes[klass];
+    page *p = cls.partial;
+    if (p == nullptr) {
+        p = &NewPage(klass, _page_size);
+    }
+
+    void *chunk = p->free;
+    if (chunk != nullptr) {
+        p->free = *static_cast<void **>(chunk);
+    } else {
+        chunk = p->fresh;
+        p->fresh += cls.chunk_size;
+    }
+
+    p->used++;
+    cls.used++;
+    if (p->used == cls.per_page) {
+        UnlinkPartial(cls, *p);
+    }
+    return chunk;
+}
+
+// See Slab.h
+void Slab::free(void *ptr) {
+    auto it = _pages.upper_bound(static_cast<char *>(ptr));
+    if (it == _pages.begin()) {
+        throw AllocError(AllocErrorType::InvalidFree, "Chunk doesn't belong to allocator");
+    }
+    --it;
+
+    page &p = it->second;
+    if (static_cast<char *>(ptr) >= static_cast<char *>(p.block.get()) + p.size) {
+        throw AllocError(AllocErrorType::InvalidFree, "Chunk doesn't belong to allocator");
+    }
+    if (p.klass == _classes.size()) {
+        _large_count--;
+        _large_bytes -= p.size;
+        ReleasePage(it);
+        return;
+    }
+
+    size_class &cls = _classes[p.klass];
+    *static_cast<void **>(ptr) = p.free;
+    p.free = ptr;
+    if (p.used == cls.per_page) {
+        LinkPartial(cls, p);
+    }
+
+    p.used--;
+    cls.used--;
+    if (p.used != 0) {
+        return;
+    }
+    if (cls.move_to != kNoMove) {
+        std::size_t to = cls.move_to;
+        cls.move_to = kNoMove;
+        MovePage(p, to);
+    } else if (p.prev != nullptr || p.next != nullptr) {
+        ReleasePage(it);
+    }
+}
+
+// See Slab.h
+std::size_t Slab::ChunkSize(std::size_t size) const {
+    std::size_t klass = ClassOf(size);
+    return klass == _classes.size() ? size : _classes[klass].chunk_size;
+}
+
+// See Slab.h
+bool Slab::Move(std::size_t from, std::size_t to) {
+    if (from == to) {
+        return true;
+    }
+
+    // Empty pages always have free chunks, so they are in the partial list
+    size_class &cls = _classes[from];
+    for (page *p = cls.partial; p != nullptr; p = p->next) {
+        if (p->used == 0) {
+            cls.move_to = kNoMove;
+            MovePage(*p, to);
+            return true;
+        }
+    }
+    cls.move_to = to;
+    return false;
+}
+
+// See Slab.h
+std::vector<Slab::class_stats> Slab::Classes() const {
+    std::vector<class_stats> result;
+    result.reserve(_classes.size());
+    for (const size_class &cls : _classes) {
+        result.push_back(class_stats{cls.chunk_size, cls.pages, cls.used, cls.pages * cls.per_page});
+    }
+    return result;
+}
+
+// See Slab.h
+std::size_t Slab::ClassOf(std::size_t size) const {
+    auto it = std::lower_bound(_classes.begin(), _classes.end(), size,
+                               [](const size_class &cls, std::size_t size) { return cls.chunk_size < size; });
+    return it - _classes.begin();
+}
+
+// See Slab.h
+Slab::page &Slab::NewPage(std::size_t klass, std::size_t size) {
+    Pointer block = _memory.alloc(size);
+    char *begin = static_cast<char *>(block.get());
+
+    page &p = _pages[begin];
+    p.block = block;
+    p.size = size;
+    p.klass = klass;
+    p.free = nullptr;
+    p.fresh = begin;
+    p.used = 0;
+    p.prev = p.next = nullptr;
+    _footprint += size;
+
+    if (klass < _classes.size()) {
+        _classes[klass].pages++;
+        LinkPartial(_classes[klass], p);
+    }
+    return p;
+}
+
+// See Slab.h
+void Slab::ReleasePage(std::map<char *, page>::iterator it) {
+    page &p = it->second;
+    if (p.klass < _classes.size()) {
+        size_class &cls = _classes[p.klass];
+        if (p.used < cls.per_page) {
+            UnlinkPartial(cls, p);
+        }
+        cls.pages--;
+    }
+    _footprint -= p.size;
+
+    _memory.free(p.block);
+    _pages.erase(it);
+}
+
+// See Slab.h
+void Slab::MovePage(page &p, std::size_t klass) {
+    size_class &from = _classes[p.klass];
+    UnlinkPartial(from, p);
+    from.pages--;
+
+    p.klass = klass;
+    p.free = nullptr;
+    p.fresh = static_cast<char *>(p.block.get());
+    _classes[klass].pages++;
+    LinkPartial(_classes[klass], p);
+    _moved_pages++;
+}
+
+// See Slab.h
+void Slab::LinkPartial(size_class &cls, page &p) {
+    p.prev = nullptr;
+    p.next = cls.partial;
+    if (cls.partial != nullptr) {
+        cls.partial->prev = &p;
+    }
+    cls.partial = &p;
+}
+
+// See Slab.h
+void Slab::UnlinkPartial(size_class &cls, page &p) {
+    if (p.prev != nullptr) {
+        p.prev->next = p.next;
+    } else {
+        cls.partial = p.next;
+    }
+    if (p.next != nullptr) {
+        p.next->prev = p.prev;
+    }
+    p.prev = p.next = nullptr;
+}
+
+} // namespace Allocator
+} // namespace Afina
@@ -0,0 +1,157 @@
+#include <afina/concurrency/Epoch.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+// Number of retired objects after which thread tries to reclaim them
+const std::size_t kCollectThreshold = 128;
+
+struct retired {
+    void *ptr;
+    void (*deleter)(void *);
+    uint64_t epoch;
+};
+
+// Announcement of the thread. Records are never deleted, record of exited thread gets reused by a new one
+struct record {
+    record() : announce(0), in_use(true), next(nullptr) {}
+
+    // Observed epoch shifted by one with the lowest bit set while thread is in critical section, 0 otherwise
+    std::atomic<uint64_t> announce;
+    std::atomic<bool> in_use;
+    record *next;
+};
+
+std::atomic<uint64_t> global_epoch(1);
+std::atomic<record *> records(nullptr);
+
+// Objects of exited threads
+std::mutex orphans_lock;
+std::vector<retired> orphans;
+
+uint64_t TryAdvance();
+void Reclaim(std::vector<retired> &garbage, uint64_t epoch);
+
+// Per thread state, gives its record and garbage back on thread exit
+struct participant {
+    participant() : self(Acquire()), depth(0) {}
+    ~participant() {
+        // Usually nobody blocks the epoch, so most of the garbage could be released right away
+        for (int i = 0; i < 2 && !garbage.empty(); i++) {
+            Reclaim(garbage, TryAdvance());
+        }
+
+        self->in_use.store(false, std::memory_order_release);
+        if (!garbage.empty()) {
+            std::lock_guard<std::mutex> lock(orphans_lock);
+            orphans.insert(orphans.end(), garbage.begin(), garbage.end());
+        }
+    }
+
+    static record *Acquire() {
+        for (record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            bool free = false;
+            if (!r->in_use.load(std::memory_order_relaxed) && r->in_use.compare_exchange_strong(free, true)) {
+                return r;
+            }
+        }
+
+        record *r = new record();
+        r->next = records.load(std::memory_order_relaxed);
+        while (!records.compare_exchange_weak(r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        return r;
+    }
+
+    record *self;
+    unsigned depth;
+    std::vector<retired> garbage;
+};
+
+participant &Self() {
+    static thread_local participant p;
+    return p;
+}
+
+// Moves epoch forward if every thread in critical section has seen the current one
+uint64_t TryAdvance() {
+    uint64_t epoch = global_epoch.load(std::memory_order_seq_cst);
+    for (record *r = records.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        uint64_t announce = r->announce.load(std::memory_order_seq_cst);
+        if ((announce & 1) != 0 && (announce >> 1) != epoch) {
+            return epoch;
+        }
+    }
+
+    global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    return global_epoch.load(std::memory_order_seq_cst);
+}
+
+// Deletes objects retired two or more epochs ago, keeps the rest
+void Reclaim(std::vector<retired> &garbage, uint64_t epoch) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < garbage.size(); i++) {
+        if (garbage[i].epoch + 2 <= epoch) {
+            garbage[i].deleter(garbage[i].ptr);
+        } else {
+            garbage[kept++] = garbage[i];
+        }
+    }
+    garbage.resize(kept);
+}
+
+} // namespace
+
+// See Epoch.h
+void Epoch::Enter() {
+    participant &p = Self();
+    if (p.depth++ == 0) {
+        // Announcement must be visible before any shared pointer is read
+        p.self->announce.store((global_epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_seq_cst);
+    }
+}
+
+// See Epoch.h
+void Epoch::Exit() {
+    participant &p = Self();
+    if (--p.depth == 0) {
+        p.self->announce.store(0, std::memory_order_release);
+    }
+}
+
+// See Epoch.h
+void Epoch::Retire(void *ptr, void (*deleter)(void *)) {
+    participant &p = Self();
+    p.garbage.push_back(retired{ptr, deleter, global_epoch.load(std::memory_order_seq_cst)});
+    if (p.garbage.size() >= kCollectThreshold) {
+        Collect();
+    }
+}
+
+// See Epoch.h
+void Epoch::Collect() {
+    participant &p = Self();
+    uint64_t epoch = TryAdvance();
+
+    // Orphans are taken over only if nobody else is doing it right now
+    std::unique_lock<std::mutex> lock(orphans_lock, std::try_to_lock);
+    if (lock.owns_lock() && !orphans.empty()) {
+        p.garbage.insert(p.garbage.end(), orphans.begin(), orphans.end());
+        orphans.clear();
+    }
+    if (lock.owns_lock()) {
+        lock.unlock();
+    }
+
+    Reclaim(p.garbage, epoch);
+}
+
+} // namespace Concurrency
+} // namespace Afina
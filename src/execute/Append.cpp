@@ -9,13 +9,9 @@ namespace Execute {
 // memcached protocol: "append" means "add this data to an existing key after existing data".
 void Append::Execute(Storage &storage, const std::string &args, std::string &out) {
     std::cout << "Append(" << _key << ")" << args << std::endl;
-    std::string value;
-    if (!storage.Get(_key, value)) {
-        out.assign("NOT_STORED");
-        return;
-    }
-    storage.Put(_key, value + args);
-    out.assign("STORED");
+    // Append keeps expiration time of the item
+    uint64_t version;
+    out.assign(storage.Append(_key, args, version) ? "STORED" : "NOT_STORED");
 }
 
 } // namespace Execute
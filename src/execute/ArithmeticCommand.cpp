@@ -0,0 +1,57 @@
+#include <afina/Storage.h>
+#include <afina/execute/ArithmeticCommand.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+// Parses decimal 64-bit unsigned integer, false if value is not a number or doesn't fit
+static bool ParseNumber(const std::string &value, uint64_t &number) {
+    if (value.empty()) {
+        return false;
+    }
+
+    number = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        uint64_t n = number * 10 + (c - '0');
+        if (number > UINT64_MAX / 10 || n < number * 10) {
+            return false;
+        }
+        number = n;
+    }
+    return true;
+}
+
+// See ArithmeticCommand.h
+void ArithmeticCommand::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::cout << "Arithmetic(" << _key << "): " << _delta << std::endl;
+
+    bool numeric = true;
+    uint64_t result = 0;
+    bool updated = storage.Update(_key, [this, &numeric, &result](const std::string &value, std::string &changed) {
+        uint64_t current;
+        if (!ParseNumber(value, current)) {
+            numeric = false;
+            return false;
+        }
+
+        result = Apply(current);
+        changed = std::to_string(result);
+        return true;
+    });
+
+    if (updated) {
+        out = std::to_string(result);
+    } else if (!numeric) {
+        out = "CLIENT_ERROR cannot increment or decrement non-numeric value";
+    } else {
+        out = "NOT_FOUND";
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,32 @@
+#include <afina/Storage.h>
+#include <afina/execute/Cas.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "cas" is a check and set operation which means "store this data but only if no one else
+// has updated since I last fetched it."
+void Cas::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::cout << "Cas(" << _key << ", " << _version << "): " << args << std::endl;
+
+    if (!storage.Versioned()) {
+        out = "SERVER_ERROR cas is not supported by storage";
+        return;
+    }
+
+    uint64_t version = _version;
+    if (storage.CompareAndSet(_key, args, Deadline(), version)) {
+        out = "STORED";
+    } else if (version == 0) {
+        out = "NOT_FOUND";
+    } else if (version != _version) {
+        out = "EXISTS";
+    } else {
+        out = "NOT_STORED";
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
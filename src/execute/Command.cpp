@@ -1 +1,27 @@
 #include <afina/execute/Command.h>
+
+#include <ctime>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: expiration time bigger than that is an absolute unix time
+static const int32_t kMaxRelativeExpire = 60 * 60 * 24 * 30;
+
+// See Command.h
+uint32_t Command::Deadline(int32_t expire) {
+    if (expire == 0) {
+        return 0;
+    }
+    if (expire < 0) {
+        // Already expired, but still not "never"
+        return 1;
+    }
+    if (expire > kMaxRelativeExpire) {
+        return expire;
+    }
+    return std::time(nullptr) + expire;
+}
+
+} // namespace Execute
+} // namespace Afina
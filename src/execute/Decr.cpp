@@ -0,0 +1,10 @@
+#include <afina/execute/Decr.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "decr" below 0 gives 0
+uint64_t Decr::Apply(uint64_t value) const { return value > _delta ? value - _delta : 0; }
+
+} // namespace Execute
+} // namespace Afina
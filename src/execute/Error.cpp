@@ -0,0 +1,15 @@
+#include <afina/execute/Error.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "ERROR\r\n" or "CLIENT_ERROR <error>\r\n" is sent back for the bad command line.
+void Error::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::cout << "Error(" << _reply << ")" << std::endl;
+    out.assign(_reply);
+}
+
+} // namespace Execute
+} // namespace Afina
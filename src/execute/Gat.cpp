@@ -0,0 +1,37 @@
+#include <afina/Storage.h>
+#include <afina/execute/Gat.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "gat" is used to fetch items and update the expiration time of an existing items.
+void Gat::Execute(Storage &storage, const std::string &args, std::string &out) {
+    Response response;
+    Execute(storage, args, response);
+    out = response.str();
+}
+
+void Gat::Execute(Storage &storage, const std::string &args, Response &out) {
+    std::cout << "Gat(" << _keys.size() << " keys): " << _expire << std::endl;
+
+    // All the keys get the same deadline even if the second changes in between
+    uint32_t deadline = Deadline(_expire);
+    std::string header;
+    for (const std::string &key : _keys) {
+        Storage::Value value;
+        if (!storage.GetAndTouch(key, deadline, value)) {
+            continue;
+        }
+        header += "VALUE " + key + " 0 " + std::to_string(value->size()) + "\r\n";
+        out.Append(std::move(header));
+        out.Append(std::move(value));
+        header = "\r\n";
+    }
+    header += "END"; // networking layer should add the last \r\n
+    out.Append(std::move(header));
+}
+
+} // namespace Execute
+} // namespace Afina
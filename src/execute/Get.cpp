@@ -4,6 +4,7 @@
 #include <iostream>
 #include <iterator>
 #include <sstream>
+#include <vector>
 
 namespace Afina {
 namespace Execute {
@@ -22,22 +23,37 @@ to indicate the end of response.
 */
 
 void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
+    Response response;
+    Execute(storage, args, response);
+    out = response.str();
+}
+
+void Get::Execute(Storage &storage, const std::string &args, Response &out) {
     std::stringstream keyStream;
     copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
     std::cout << "Get(" << keyStream.str() << ")" << std::endl;
 
-    std::stringstream outStream;
-
-    std::string value;
+    // Whole batch is looked up at once, each key is hashed once for all storage layers. Values are sent right
+    // from the storage buffers
+    std::vector<Key> refs;
+    refs.reserve(_keys.size());
     for (auto &key : _keys) {
-        if (!storage.Get(key, value))
-            continue;
-        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
-        outStream << value << "\r\n";
+        refs.emplace_back(key);
     }
-    outStream << "END"; // networking layer should add the last \r\n
+    std::vector<Storage::Value> values(_keys.size());
+    storage.MultiGet(refs.data(), refs.size(), values.data());
 
-    out = outStream.str();
+    std::string header;
+    for (std::size_t i = 0; i < _keys.size(); i++) {
+        if (!values[i])
+            continue;
+        header += "VALUE " + _keys[i] + " 0 " + std::to_string(values[i]->size()) + "\r\n";
+        out.Append(std::move(header));
+        out.Append(std::move(values[i]));
+        header = "\r\n";
+    }
+    header += "END"; // networking layer should add the last \r\n
+    out.Append(std::move(header));
 }
 
 } // namespace Execute
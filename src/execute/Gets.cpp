@@ -0,0 +1,40 @@
+#include <afina/Storage.h>
+#include <afina/execute/Gets.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+void Gets::Execute(Storage &storage, const std::string &args, std::string &out) {
+    Response response;
+    Execute(storage, args, response);
+    out = response.str();
+}
+
+void Gets::Execute(Storage &storage, const std::string &args, Response &out) {
+    std::cout << "Gets(" << _keys.size() << " keys)" << std::endl;
+
+    if (!storage.Versioned()) {
+        out.Append(std::string("SERVER_ERROR gets is not supported by storage"));
+        return;
+    }
+
+    std::string header;
+    for (const std::string &key : _keys) {
+        Storage::Value value;
+        uint64_t version;
+        if (!storage.GetVersion(key, value, version)) {
+            continue;
+        }
+        header += "VALUE " + key + " 0 " + std::to_string(value->size()) + " " + std::to_string(version) + "\r\n";
+        out.Append(std::move(header));
+        out.Append(std::move(value));
+        header = "\r\n";
+    }
+    header += "END"; // networking layer should add the last \r\n
+    out.Append(std::move(header));
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,10 @@
+#include <afina/execute/Incr.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "incr" wraps around on 64-bit overflow
+uint64_t Incr::Apply(uint64_t value) const { return value + _delta; }
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,55 @@
+#include <afina/Storage.h>
+#include <afina/execute/Keys.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+constexpr std::size_t Keys::kMaxKeys;
+constexpr std::size_t Keys::kBatchSize;
+
+// See Keys.h
+void Keys::Execute(Storage &storage, const std::string &args, std::string &out) {
+    Response response;
+    Execute(storage, args, response);
+    out = response.str();
+}
+
+// See Keys.h
+void Keys::Execute(Storage &storage, const std::string &args, Response &out) {
+    std::cout << "Keys(" << _prefix << ")" << std::endl;
+
+    // Storage which can't scan never calls visit, so nothing is added before the error
+    std::string batch;
+    std::size_t count = 0;
+    bool truncated = false;
+    bool supported = storage.Scan(_prefix, [&](const std::string &key, const Storage::Value &) {
+        if (count == kMaxKeys) {
+            truncated = true;
+            return false;
+        }
+        count++;
+
+        batch.append("KEY ").append(key).append("\r\n");
+        if (batch.size() >= kBatchSize) {
+            out.Append(std::move(batch));
+            batch.clear();
+        }
+        return true;
+    });
+
+    if (!supported) {
+        out.Append(std::string("SERVER_ERROR keys scan is not supported by storage"));
+        return;
+    }
+
+    if (truncated) {
+        batch += "TRUNCATED\r\n";
+    }
+    batch += "END"; // networking layer should add the last \r\n
+    out.Append(std::move(batch));
+}
+
+} // namespace Execute
+} // namespace Afina
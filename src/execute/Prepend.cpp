@@ -0,0 +1,18 @@
+#include <afina/Storage.h>
+#include <afina/execute/Prepend.h>
+
+#include <iostream>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "prepend" means "add this data to an existing key before existing data".
+void Prepend::Execute(Storage &storage, const std::string &args, std::string &out) {
+    std::cout << "Prepend(" << _key << ")" << args << std::endl;
+    // Prepend keeps expiration time of the item
+    uint64_t version;
+    out.assign(storage.Prepend(_key, args, version) ? "STORED" : "NOT_STORED");
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,40 @@
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Response.h
+void Response::Append(std::string text) {
+    _size += text.size();
+    _parts.push_back(part{std::move(text), nullptr});
+}
+
+// See Response.h
+void Response::Append(std::shared_ptr<const std::string> buffer) {
+    _size += buffer->size();
+    _parts.push_back(part{std::string(), std::move(buffer)});
+}
+
+// See Response.h
+void Response::Gather(std::vector<struct iovec> &iov) const {
+    iov.reserve(iov.size() + _parts.size());
+    for (const part &p : _parts) {
+        const std::string &data = p.data();
+        if (!data.empty()) {
+            iov.push_back(iovec{const_cast<char *>(data.data()), data.size()});
+        }
+    }
+}
+
+// See Response.h
+std::string Response::str() const {
+    std::string result;
+    result.reserve(_size);
+    for (const part &p : _parts) {
+        result += p.data();
+    }
+    return result;
+}
+
+} // namespace Execute
+} // namespace Afina
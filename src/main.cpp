@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -21,7 +22,17 @@
 #include "network/st_coroutine/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
 
+#include "storage/BasicCache.h"
+#include "storage/BufferedLRU.h"
+#include "storage/CircularLog.h"
+#include "storage/CompactLRU.h"
+#include "storage/ConcurrentClock.h"
+#include "storage/OrderedLRU.h"
+#include "storage/ShardedLRU.h"
+#include "storage/SimpleClock.h"
 #include "storage/SimpleLRU.h"
+#include "storage/ThreadSafeClock.h"
+#include "storage/TinyLFU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
 
 using namespace Afina;
@@ -51,10 +62,50 @@ public:
             storage_type = options["storage"].as<std::string>();
         }
 
+        // Every storage gets the same memory budget, sharded one splits it between shards
+        size_t memory = 1024;
+        if (options.count("memory") > 0) {
+            memory = options["memory"].as<size_t>();
+        }
+
         if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
+            storage = std::make_shared<Afina::Backend::SimpleLRU>(memory);
         } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(memory);
+        } else if (storage_type == "st_ordered_lru") {
+            storage = std::make_shared<Afina::Backend::OrderedLRU>(memory);
+        } else if (storage_type == "st_circular_log") {
+            storage = std::make_shared<Afina::Backend::CircularLog>(memory);
+        } else if (storage_type == "st_compact_lru") {
+            storage = std::make_shared<Afina::Backend::CompactLRU>(memory);
+        } else if (storage_type == "st_clock") {
+            storage = std::make_shared<Afina::Backend::SimpleClock>(memory);
+        } else if (storage_type == "mt_clock") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeClock>(memory);
+        } else if (storage_type == "mt_concurrent_clock") {
+            storage = std::make_shared<Afina::Backend::ConcurrentClock>(memory);
+        } else if (storage_type == "st_tinylfu") {
+            storage = std::make_shared<Afina::Backend::TinyLFU>(memory);
+        } else if (storage_type == "mt_buffered_lru") {
+            storage = std::make_shared<Afina::Backend::BufferedLRU>(memory);
+        } else if (storage_type == "st_basic_lru") {
+            storage = std::make_shared<Afina::Backend::BasicLRU>(memory);
+        } else if (storage_type == "mt_basic_lru") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeBasicLRU>(memory);
+        } else if (storage_type == "st_basic_clock") {
+            storage = std::make_shared<Afina::Backend::BasicClock>(memory);
+        } else if (storage_type == "mt_basic_clock") {
+            storage = std::make_shared<Afina::Backend::ThreadSafeBasicClock>(memory);
+        } else if (storage_type == "st_basic_ordered_lru") {
+            storage = std::make_shared<Afina::Backend::BasicOrderedLRU>(memory);
+        } else if (storage_type == "sharded_lru") {
+            // By default there are as many shards as the budget allows, but not more than 16
+            size_t shards = memory / Afina::Backend::ShardedLRU::kMinShardSize;
+            shards = std::max<size_t>(1, std::min<size_t>(16, shards));
+            if (options.count("shards") > 0) {
+                shards = options["shards"].as<size_t>();
+            }
+            storage = std::make_shared<Afina::Backend::ShardedLRU>(memory, shards);
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -131,6 +182,8 @@ int main(int argc, char **argv) {
         // TODO: use custom cxxopts::value to print options possible values in help message
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
+        options.add_options()("m,memory", "Memory budget of storage in bytes", cxxopts::value<size_t>());
+        options.add_options()("shards", "Number of shards for sharded storage", cxxopts::value<size_t>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
@@ -1,10 +1,14 @@
 #include "ServerImpl.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cerrno>
+#include <climits>
 #include <cstring>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 
 #include <arpa/inet.h>
 #include <netdb.h>
@@ -13,20 +17,55 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <spdlog/logger.h>
 
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
 #include <afina/logging/Service.h>
 
+#include "protocol/Binary.h"
+#include "protocol/BinaryParser.h"
 #include "protocol/Parser.h"
 
 namespace Afina {
 namespace Network {
 namespace STblocking {
 
+namespace {
+
+// Writes all buffers of the response with gathering writes, values are sent right from the storage memory
+void SendResponse(int socket, const Execute::Response &response) {
+    std::vector<struct iovec> iov;
+    response.Gather(iov);
+
+    std::size_t first = 0;
+    while (first < iov.size()) {
+        int count = std::min<std::size_t>(iov.size() - first, IOV_MAX);
+        ssize_t sent = writev(socket, &iov[first], count);
+        if (sent <= 0) {
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to send response");
+        }
+
+        // Skip buffers sent completely and move start of the partially sent one
+        for (; first < iov.size() && std::size_t(sent) >= iov[first].iov_len; first++) {
+            sent -= iov[first].iov_len;
+        }
+        if (sent > 0) {
+            iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + sent;
+            iov[first].iov_len -= sent;
+        }
+    }
+}
+
+} // namespace
+
 // See Server.h
 ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
 
@@ -122,11 +161,14 @@ void ServerImpl::Join() {
 void ServerImpl::OnRun() {
     // Here is connection state
     // - parser: parse state of the stream
+    // - binary: connection speaks memcached binary protocol, then binary_parser is used instead of parser
     // - command_to_execute: last command parsed out of stream
     // - arg_remains: how many bytes to read from stream to get command argument
     // - argument_for_command: buffer stores argument
     std::size_t arg_remains;
     Protocol::Parser parser;
+    Protocol::BinaryParser binary_parser;
+    bool binary;
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
     while (running.load()) {
@@ -168,9 +210,17 @@ void ServerImpl::OnRun() {
         try {
             int readed_bytes = -1;
             char client_buffer[4096];
+            bool detected = false;
             while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
                 _logger->debug("Got {} bytes from socket", readed_bytes);
 
+                // Protocol is told by the first byte client sends, text commands never start with the binary magic
+                if (!detected) {
+                    binary = uint8_t(client_buffer[0]) == Protocol::Binary::kRequestMagic;
+                    detected = true;
+                    _logger->debug("Connection uses {} protocol", binary ? "binary" : "text");
+                }
+
                 // Single block of data readed from the socket could trigger inside actions a multiple times,
                 // for example:
                 // - read#0: [<command1 start>]
@@ -180,7 +230,13 @@ void ServerImpl::OnRun() {
                     // There is no command yet
                     if (!command_to_execute) {
                         std::size_t parsed = 0;
-                        if (parser.Parse(client_buffer, readed_bytes, parsed)) {
+                        if (binary) {
+                            if (binary_parser.Parse(client_buffer, readed_bytes, parsed)) {
+                                _logger->debug("Found new binary command: {} in {} bytes", int(binary_parser.Opcode()),
+                                               parsed);
+                                command_to_execute = binary_parser.Build(arg_remains);
+                            }
+                        } else if (parser.Parse(client_buffer, readed_bytes, parsed)) {
                             // There is no command to be launched, continue to parse input stream
                             // Here we are, current chunk finished some command, process it
                             _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
@@ -216,22 +272,25 @@ void ServerImpl::OnRun() {
                     if (command_to_execute && arg_remains == 0) {
                         _logger->debug("Start command execution");
 
-                        std::string result;
-                        if (argument_for_command.size()) {
+                        Execute::Response result;
+                        if (!binary && argument_for_command.size()) {
                             argument_for_command.resize(argument_for_command.size() - 2);
                         }
                         command_to_execute->Execute(*pStorage, argument_for_command, result);
 
-                        // Send response
-                        result += "\r\n";
-                        if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                            throw std::runtime_error("Failed to send response");
+                        // Send response, binary one is length-prefixed and quiet commands could have none at all
+                        if (!binary) {
+                            result.Append("\r\n");
+                        }
+                        if (result.Size() > 0) {
+                            SendResponse(client_socket, result);
                         }
 
                         // Prepare for the next command
                         command_to_execute.reset();
                         argument_for_command.resize(0);
                         parser.Reset();
+                        binary_parser.Reset();
                     }
                 } // while (readed_bytes)
             }
@@ -252,6 +311,7 @@ void ServerImpl::OnRun() {
         command_to_execute.reset();
         argument_for_command.resize(0);
         parser.Reset();
+        binary_parser.Reset();
     }
 
     // Cleanup on exit...
@@ -0,0 +1,86 @@
+#ifndef AFINA_PROTOCOL_BINARY_H
+#define AFINA_PROTOCOL_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Afina {
+namespace Protocol {
+namespace Binary {
+
+/**
+ * # Memcached binary protocol wire format
+ * Every request and response starts with the fixed 24 bytes header, all numbers there are big-endian:
+ *
+ *   0 magic | 1 opcode | 2-3 key length | 4 extras length | 5 data type | 6-7 vbucket/status |
+ *   8-11 total body length | 12-15 opaque | 16-23 cas
+ *
+ * Header is followed by extras, key and value, in that order. Value length is not sent, it is the body length
+ * minus extras and key ones. Opaque is copied from request to response as is, so client could match them.
+ */
+constexpr std::size_t kHeaderSize = 24;
+
+// First byte of each request and response. Text commands never start with that byte, so it tells the protocol
+constexpr uint8_t kRequestMagic = 0x80;
+constexpr uint8_t kResponseMagic = 0x81;
+
+// Commands server supports. Quiet ones send nothing back unless there is an error, quiet gets send nothing on miss
+enum Opcode : uint8_t {
+    oGet = 0x00,
+    oSet = 0x01,
+    oAdd = 0x02,
+    oReplace = 0x03,
+    oDelete = 0x04,
+    oIncrement = 0x05,
+    oDecrement = 0x06,
+    oGetQ = 0x09,
+    oNoop = 0x0a,
+    oGetK = 0x0c,
+    oGetKQ = 0x0d,
+    oAppend = 0x0e,
+    oPrepend = 0x0f,
+    oSetQ = 0x11,
+    oAddQ = 0x12,
+    oReplaceQ = 0x13,
+    oDeleteQ = 0x14,
+    oIncrementQ = 0x15,
+    oDecrementQ = 0x16,
+    oAppendQ = 0x19,
+    oPrependQ = 0x1a,
+    oTouch = 0x1c,
+    oGat = 0x1d,
+    oGatQ = 0x1e
+};
+
+enum Status : uint16_t {
+    sOk = 0x0000,
+    sKeyNotFound = 0x0001,
+    sKeyExists = 0x0002,
+    sInvalidArguments = 0x0004,
+    sNotStored = 0x0005,
+    sNonNumeric = 0x0006,
+    sUnknownCommand = 0x0081,
+    sNotSupported = 0x0083
+};
+
+// Big-endian numbers of the header and extras
+inline uint64_t Load(const char *data, std::size_t size) {
+    uint64_t result = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        result = (result << 8) | uint8_t(data[i]);
+    }
+    return result;
+}
+
+inline void Store(char *data, std::size_t size, uint64_t value) {
+    for (std::size_t i = size; i > 0; i--) {
+        data[i - 1] = char(value & 0xff);
+        value >>= 8;
+    }
+}
+
+} // namespace Binary
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_BINARY_H
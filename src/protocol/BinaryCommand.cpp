@@ -0,0 +1,322 @@
+#include "BinaryCommand.h"
+#include "Binary.h"
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Protocol {
+
+using namespace Binary;
+
+namespace {
+
+// Not quiet version of the opcode
+uint8_t Loud(uint8_t opcode, bool &quiet) {
+    quiet = true;
+    switch (opcode) {
+    case oGetQ:
+        return oGet;
+    case oGetKQ:
+        return oGetK;
+    case oSetQ:
+        return oSet;
+    case oAddQ:
+        return oAdd;
+    case oReplaceQ:
+        return oReplace;
+    case oDeleteQ:
+        return oDelete;
+    case oIncrementQ:
+        return oIncrement;
+    case oDecrementQ:
+        return oDecrement;
+    case oAppendQ:
+        return oAppend;
+    case oPrependQ:
+        return oPrepend;
+    case oGatQ:
+        return oGat;
+    default:
+        quiet = false;
+        return opcode;
+    }
+}
+
+// Value of the error response, the same memcached sends
+const char *Message(uint16_t status) {
+    switch (status) {
+    case sKeyNotFound:
+        return "Not found";
+    case sKeyExists:
+        return "Data exists for key.";
+    case sInvalidArguments:
+        return "Invalid arguments";
+    case sNotStored:
+        return "Not stored.";
+    case sNonNumeric:
+        return "Non-numeric server-side value for incr or decr";
+    case sNotSupported:
+        return "Not supported";
+    default:
+        return "Unknown command";
+    }
+}
+
+// Parses decimal 64-bit unsigned integer, false if value is not a number or doesn't fit
+bool ParseNumber(const std::string &value, uint64_t &number) {
+    if (value.empty()) {
+        return false;
+    }
+
+    number = 0;
+    for (char c : value) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        uint64_t n = number * 10 + (c - '0');
+        if (number > UINT64_MAX / 10 || n < number * 10) {
+            return false;
+        }
+        number = n;
+    }
+    return true;
+}
+
+} // namespace
+
+// See BinaryCommand.h
+void BinaryCommand::Execute(Storage &storage, const std::string &args, std::string &out) {
+    Execute::Response response;
+    Execute(storage, args, response);
+    out = response.str();
+}
+
+// See BinaryCommand.h
+void BinaryCommand::Execute(Storage &storage, const std::string &args, Execute::Response &out) {
+    bool quiet;
+    uint8_t opcode = Loud(_opcode, quiet);
+    switch (opcode) {
+    case oGet:
+    case oGetK:
+    case oGat: {
+        if (_key.empty() || _extras.size() != (opcode == oGat ? 4 : 0)) {
+            Error(out, sInvalidArguments);
+            return;
+        }
+
+        Storage::Value value;
+        uint64_t version = 0;
+        bool found = opcode == oGat ? storage.GetAndTouch(_key, Deadline(int32_t(Load(_extras.data(), 4))), value)
+                                    : storage.GetVersion(_key, value, version);
+        if (!found) {
+            if (!quiet) {
+                Error(out, sKeyNotFound);
+            }
+            return;
+        }
+        if (opcode == oGat) {
+            version = Version(storage);
+        }
+
+        // Flags are not stored, so they are always 0
+        Header(out, sOk, std::string(4, '\0'), opcode == oGetK ? _key : std::string(), value->size(), version);
+        out.Append(std::move(value));
+        return;
+    }
+
+    case oSet:
+    case oAdd:
+    case oReplace:
+    case oAppend:
+    case oPrepend: {
+        uint64_t version = 0;
+        uint16_t status = Store(storage, opcode, args, version);
+        if (status != sOk) {
+            Error(out, status);
+        } else if (!quiet) {
+            Header(out, sOk, std::string(), std::string(), 0, version);
+        }
+        return;
+    }
+
+    case oDelete: {
+        uint16_t status = sInvalidArguments;
+        if (!_key.empty() && _extras.empty()) {
+            status = storage.Delete(_key) ? sOk : sKeyNotFound;
+        }
+        if (status != sOk) {
+            Error(out, status);
+        } else if (!quiet) {
+            Header(out, sOk, std::string(), std::string(), 0, 0);
+        }
+        return;
+    }
+
+    case oIncrement:
+    case oDecrement: {
+        uint64_t result = 0;
+        uint16_t status = Arithmetic(storage, opcode, result);
+        if (status != sOk) {
+            Error(out, status);
+        } else if (!quiet) {
+            std::string value(8, '\0');
+            Binary::Store(&value[0], 8, result);
+            Header(out, sOk, std::string(), std::string(), value.size(), Version(storage));
+            out.Append(std::move(value));
+        }
+        return;
+    }
+
+    case oTouch: {
+        if (_key.empty() || _extras.size() != 4) {
+            Error(out, sInvalidArguments);
+        } else if (!storage.Touch(_key, Deadline(int32_t(Load(_extras.data(), 4))))) {
+            Error(out, sKeyNotFound);
+        } else {
+            Header(out, sOk, std::string(), std::string(), 0, Version(storage));
+        }
+        return;
+    }
+
+    case oNoop:
+        Header(out, sOk, std::string(), std::string(), 0, 0);
+        return;
+
+    default:
+        Error(out, sUnknownCommand);
+    }
+}
+
+// See BinaryCommand.h
+uint16_t BinaryCommand::Store(Storage &storage, uint8_t opcode, const std::string &value, uint64_t &version) const {
+    if (_key.empty()) {
+        return sInvalidArguments;
+    }
+    if (opcode == oAppend || opcode == oPrepend) {
+        if (!_extras.empty()) {
+            return sInvalidArguments;
+        }
+        bool stored = opcode == oAppend ? storage.Append(_key, value, version) : storage.Prepend(_key, value, version);
+        return stored ? sOk : sNotStored;
+    }
+
+    // Extras are flags and expiration time, storage doesn't keep flags
+    if (_extras.size() != 8) {
+        return sInvalidArguments;
+    }
+    uint32_t expire = Deadline(int32_t(Load(_extras.data() + 4, 4)));
+
+    if (_cas != 0) {
+        if (opcode == oAdd) {
+            return sInvalidArguments;
+        }
+        if (!storage.Versioned()) {
+            return sNotSupported;
+        }
+
+        version = _cas;
+        if (storage.CompareAndSet(_key, value, expire, version)) {
+            return sOk;
+        }
+        uint16_t status = version == 0 ? sKeyNotFound : version != _cas ? sKeyExists : sNotStored;
+        version = 0;
+        return status;
+    }
+
+    uint16_t status;
+    switch (opcode) {
+    case oAdd:
+        status = storage.PutIfAbsent(_key, value, expire) ? sOk : sKeyExists;
+        break;
+    case oReplace:
+        status = storage.Set(_key, value, expire) ? sOk : sKeyNotFound;
+        break;
+    default:
+        status = storage.Put(Key(_key), value, expire) ? sOk : sNotStored;
+    }
+    if (status == sOk) {
+        version = Version(storage);
+    }
+    return status;
+}
+
+// See BinaryCommand.h
+uint16_t BinaryCommand::Arithmetic(Storage &storage, uint8_t opcode, uint64_t &result) const {
+    // Extras are delta, initial value and expiration time of the item created if there is none yet
+    if (_key.empty() || _extras.size() != 20) {
+        return sInvalidArguments;
+    }
+    uint64_t delta = Load(_extras.data(), 8);
+    uint64_t initial = Load(_extras.data() + 8, 8);
+    uint32_t expiration = Load(_extras.data() + 16, 4);
+
+    // Item could be created by somebody else between update and put, then it is updated once again
+    for (int attempt = 0; attempt < 2; attempt++) {
+        bool numeric = true;
+        bool updated = storage.Update(_key, [&](const std::string &value, std::string &changed) {
+            uint64_t current;
+            if (!ParseNumber(value, current)) {
+                numeric = false;
+                return false;
+            }
+
+            // Increment wraps around, decrement stops at zero
+            if (opcode == oIncrement) {
+                result = current + delta;
+            } else {
+                result = current > delta ? current - delta : 0;
+            }
+            changed = std::to_string(result);
+            return true;
+        });
+
+        if (updated) {
+            return sOk;
+        } else if (!numeric) {
+            return sNonNumeric;
+        } else if (expiration == UINT32_MAX) {
+            // Client asked not to create the item
+            return sKeyNotFound;
+        } else if (storage.PutIfAbsent(_key, std::to_string(initial), Deadline(int32_t(expiration)))) {
+            result = initial;
+            return sOk;
+        }
+    }
+    return sNotStored;
+}
+
+// See BinaryCommand.h
+uint64_t BinaryCommand::Version(Storage &storage) const {
+    Storage::Value value;
+    uint64_t version = 0;
+    storage.GetVersion(_key, value, version);
+    return version;
+}
+
+// See BinaryCommand.h
+void BinaryCommand::Header(Execute::Response &out, uint16_t status, const std::string &extras,
+                           const std::string &key, std::size_t value_size, uint64_t cas) const {
+    std::string header(kHeaderSize, '\0');
+    char *data = &header[0];
+    data[0] = char(kResponseMagic);
+    data[1] = char(_opcode);
+    Binary::Store(data + 2, 2, key.size());
+    data[4] = char(extras.size());
+    Binary::Store(data + 6, 2, status);
+    Binary::Store(data + 8, 4, extras.size() + key.size() + value_size);
+    Binary::Store(data + 12, 4, _opaque);
+    Binary::Store(data + 16, 8, cas);
+
+    header.append(extras).append(key);
+    out.Append(std::move(header));
+}
+
+// See BinaryCommand.h
+void BinaryCommand::Error(Execute::Response &out, uint16_t status) const {
+    std::string message(Message(status));
+    Header(out, status, std::string(), std::string(), message.size(), 0);
+    out.Append(std::move(message));
+}
+
+} // namespace Protocol
+} // namespace Afina
@@ -0,0 +1,67 @@
+#ifndef AFINA_PROTOCOL_BINARY_COMMAND_H
+#define AFINA_PROTOCOL_BINARY_COMMAND_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <afina/execute/Command.h>
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * # Request of the memcached binary protocol
+ * Runs the request against storage and writes binary response, see Binary.h. Values are sent right from the
+ * storage memory, same as for text get. Nothing is written for quiet requests which succeeded and for quiet gets
+ * which missed, network layer must not send empty response.
+ *
+ * Flags are not kept by storage, so gets always return 0 ones. Successful responses for an item carry its version
+ * as cas, 0 if storage doesn't keep versions. Compare and set, append and prepend get the version from the write
+ * itself, others read it right after the write, so if item is changed or evicted in between, cas is the version
+ * of that change or 0
+ */
+class BinaryCommand : public Execute::Command {
+public:
+    BinaryCommand(uint8_t opcode, uint32_t opaque, uint64_t cas, std::string extras, std::string key)
+        : _opcode(opcode), _opaque(opaque), _cas(cas), _extras(std::move(extras)), _key(std::move(key)) {}
+    ~BinaryCommand() {}
+
+    inline uint8_t opcode() const { return _opcode; }
+    inline uint32_t opaque() const { return _opaque; }
+    inline uint64_t cas() const { return _cas; }
+    inline const std::string &extras() const { return _extras; }
+    inline const std::string &key() const { return _key; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+    void Execute(Storage &storage, const std::string &args, Execute::Response &out) override;
+
+private:
+    // Storage commands: set, add, replace, append and prepend, opcode is the not quiet one. Version gets the version
+    // of the stored item
+    uint16_t Store(Storage &storage, uint8_t opcode, const std::string &value, uint64_t &version) const;
+
+    // Increment and decrement, opcode is the not quiet one. Result gets the new value
+    uint16_t Arithmetic(Storage &storage, uint8_t opcode, uint64_t &result) const;
+
+    // Current version of the item, 0 if there is none
+    uint64_t Version(Storage &storage) const;
+
+    // Appends response header, body is extras, key and value_size bytes of value which caller appends after that
+    void Header(Execute::Response &out, uint16_t status, const std::string &extras, const std::string &key,
+                std::size_t value_size, uint64_t cas) const;
+
+    // Appends response with the error message as a value
+    void Error(Execute::Response &out, uint16_t status) const;
+
+    uint8_t _opcode;
+    uint32_t _opaque;
+    uint64_t _cas;
+    std::string _extras;
+    std::string _key;
+};
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_BINARY_COMMAND_H
@@ -0,0 +1,70 @@
+#include "BinaryParser.h"
+#include "Binary.h"
+#include "BinaryCommand.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Afina {
+namespace Protocol {
+
+// See BinaryParser.h
+bool BinaryParser::Parse(const char *input, const std::size_t size, std::size_t &parsed) {
+    parsed = 0;
+    if (head.size() < Binary::kHeaderSize) {
+        parsed = std::min(Binary::kHeaderSize - head.size(), size);
+        head.append(input, parsed);
+        if (head.size() < Binary::kHeaderSize) {
+            return false;
+        }
+
+        const char *header = head.data();
+        if (uint8_t(header[0]) != Binary::kRequestMagic) {
+            throw std::runtime_error("Invalid magic byte of binary request");
+        }
+        opcode = uint8_t(header[1]);
+        key_length = Binary::Load(header + 2, 2);
+        extras_length = uint8_t(header[4]);
+        body_length = Binary::Load(header + 8, 4);
+        opaque = Binary::Load(header + 12, 4);
+        cas = Binary::Load(header + 16, 8);
+
+        if (std::size_t(extras_length) + key_length > body_length) {
+            throw std::runtime_error("Binary request body is shorter than its extras and key");
+        }
+    }
+
+    // Extras and key are small, they are copied right after the header
+    std::size_t want = Binary::kHeaderSize + extras_length + key_length - head.size();
+    std::size_t taken = std::min(want, size - parsed);
+    head.append(input + parsed, taken);
+    parsed += taken;
+    return taken == want;
+}
+
+// See BinaryParser.h
+std::unique_ptr<Execute::Command> BinaryParser::Build(std::size_t &body_size) const {
+    std::size_t size = Binary::kHeaderSize + extras_length + key_length;
+    if (head.size() < Binary::kHeaderSize || head.size() != size) {
+        return std::unique_ptr<Execute::Command>(nullptr);
+    }
+
+    body_size = body_length - extras_length - key_length;
+    return std::unique_ptr<Execute::Command>(
+        new BinaryCommand(opcode, opaque, cas, head.substr(Binary::kHeaderSize, extras_length),
+                          head.substr(Binary::kHeaderSize + extras_length, key_length)));
+}
+
+// See BinaryParser.h
+void BinaryParser::Reset() {
+    head.clear();
+    opcode = 0;
+    extras_length = 0;
+    key_length = 0;
+    body_length = 0;
+    opaque = 0;
+    cas = 0;
+}
+
+} // namespace Protocol
+} // namespace Afina
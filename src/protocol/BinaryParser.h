@@ -0,0 +1,64 @@
+#ifndef AFINA_PROTOCOL_BINARY_PARSER_H
+#define AFINA_PROTOCOL_BINARY_PARSER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <afina/execute/Command.h>
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * # Memcached binary protocol parser
+ * Same contract as the text Parser: Parse consumes request header, extras and key, then Build gives out command
+ * and tells how many bytes of value follows. All fields are length-prefixed, so input is never scanned, parser
+ * just copies known number of bytes. Command writes binary response, see Binary.h
+ */
+class BinaryParser {
+public:
+    BinaryParser() { Reset(); }
+
+    /**
+     * Push given bytes into parser input. Method returns true if request header, extras and key are all parsed
+     * out, in a such case method Build will return new command. Throws std::runtime_error if input isn't a binary
+     * request, there is no way to find the next request in that case, so connection should be closed
+     *
+     * @param input bytes to be added to the parsed input
+     * @param size number of bytes in the input buffer that could be read
+     * @param parsed output parameter tells how many bytes was consumed from the input
+     * @return true if command has been parsed out
+     */
+    bool Parse(const char *input, const std::size_t size, std::size_t &parsed);
+
+    /**
+     * Builds new command from parsed input, body_size gets the value length. In case if it wasn't enough input to
+     * parse command out method return nullptr
+     */
+    std::unique_ptr<Execute::Command> Build(std::size_t &body_size) const;
+
+    /**
+     * Reset parser so that it could be used to parse out new command
+     */
+    void Reset();
+
+    inline uint8_t Opcode() const { return opcode; }
+
+private:
+    // Request header, extras and key
+    std::string head;
+
+    // Header fields, valid once head has the whole header
+    uint8_t opcode;
+    uint8_t extras_length;
+    uint16_t key_length;
+    uint32_t body_length;
+    uint32_t opaque;
+    uint64_t cas;
+};
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_BINARY_PARSER_H
@@ -1,24 +1,39 @@
 #include "Parser.h"
+#include "Scan.h"
 
+#include <cstdint>
+#include <cstring>
 #include <iostream>
-#include <sstream>
-#include <stdexcept>
+#include <utility>
 
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
+#include <afina/execute/Cas.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Decr.h>
 #include <afina/execute/Delete.h>
+#include <afina/execute/Error.h>
+#include <afina/execute/Gat.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Gets.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Keys.h>
+#include <afina/execute/Prepend.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
 
 namespace Afina {
 namespace Protocol {
 
+constexpr const char *Parser::kUnknownCommand;
+constexpr const char *Parser::kBadFormat;
+
 // See Parse.h
 bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
     size_t pos;
     parsed = 0;
+    buffer = input;
 
     for (pos = 0; pos < size && !parse_complete; pos++) {
         char c = input[pos];
@@ -27,19 +42,45 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
         switch (state) {
         case State::sName: {
             if (c == ' ' || c == '\r') {
-                // std::cout << "parser debug: name='" << name << "'" << std::endl;
-                if (name == "set" || name == "add" || name == "append" || name == "prepend") {
+                // std::cout << "parser debug: name='" << Name() << "'" << std::endl;
+                verb = Lookup(name);
+                switch (verb) {
+                case vSet:
+                case vAdd:
+                case vAppend:
+                case vPrepend:
+                case vCas:
                     state = State::spKey;
-                } else if (name == "get" || name == "gets") {
+                    break;
+                case vGet:
+                case vGets:
                     state = State::sgKey;
-                } else if (name == "stats") {
+                    break;
+                case vStats:
                     state = State::sLF;
                     continue;
-                } else {
-                    throw std::runtime_error("Unknown command name: " + name);
+                case vIncr:
+                case vDecr:
+                case vTouch:
+                    state = State::saKey;
+                    break;
+                case vGat:
+                    state = State::sgExprTime;
+                    break;
+                case vKeys:
+                    // Prefix is optional, keys without it lists everything
+                    state = c == ' ' ? State::sgKey : State::sLF;
+                    break;
+                default:
+                    Fail(kUnknownCommand, c);
+                }
+
+                // Line ends right after the name of command which has arguments
+                if (c == '\r' && state != State::sLF && error == nullptr) {
+                    Fail(kUnknownCommand, c);
                 }
             } else {
-                name.push_back(c);
+                pos = Take(name, input, pos, size);
             }
             break;
         }
@@ -48,9 +89,12 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
             if (c == ' ') {
                 state = State::spFlags;
                 keys.push_back(curKey);
-                // std::cout << "parser debug: key[" << keys.size() - 1 << "]='" << curKey << "'" << std::endl;
+                curKey = token{0, 0, false};
+            } else if (c == '\r') {
+                // Line ends before the arguments, the bad line is skipped up to its own \n
+                Fail(kBadFormat, c);
             } else {
-                curKey.push_back(c);
+                pos = Take(curKey, input, pos, size);
             }
             break;
         }
@@ -60,19 +104,57 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 keys.push_back(curKey);
                 // std::cout << "parser debug: total '" << keys.size() << " keys" << std::endl;
 
-                if (keys.size() == 0) {
-                    throw std::runtime_error("Client provides no key to retrive");
-                }
-
-                curKey.clear();
+                curKey = token{0, 0, false};
                 state = State::sLF;
             } else if (c == ' ') {
-                // std::cout << "parser debug: key[" << keys.size() << "]='" << curKey << "'" << std::endl;
                 state = State::sgKey;
                 keys.push_back(curKey);
-                curKey.clear();
+                curKey = token{0, 0, false};
             } else {
-                curKey.push_back(c);
+                pos = Take(curKey, input, pos, size);
+            }
+            break;
+        }
+
+        case State::sgExprTime: {
+            if (c == ' ') {
+                if (NumberAsExpire(exprtime)) {
+                    state = State::sgKey;
+                } else {
+                    Fail(kBadFormat, c);
+                }
+            } else if (c == '-' && number == 0 && !negative) {
+                negative = true;
+            } else if (!PushDigit(c)) {
+                Fail(kBadFormat, c);
+            }
+            break;
+        }
+
+        case State::saKey: {
+            if (c == ' ') {
+                state = State::saNumber;
+                keys.push_back(curKey);
+                curKey = token{0, 0, false};
+            } else if (c == '\r') {
+                Fail(kBadFormat, c);
+            } else {
+                pos = Take(curKey, input, pos, size);
+            }
+            break;
+        }
+
+        case State::saNumber: {
+            if (c == '\r') {
+                if (verb != vTouch || NumberAsExpire(exprtime)) {
+                    state = State::sLF;
+                } else {
+                    Fail(kBadFormat, c);
+                }
+            } else if (c == '-' && verb == vTouch && number == 0 && !negative) {
+                negative = true;
+            } else if (!PushDigit(c)) {
+                Fail(kBadFormat, c);
             }
             break;
         }
@@ -86,9 +168,12 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 uint32_t f = (flags * 10) + (c - '0');
                 if (f < flags) {
                     // Overflow
-                    throw std::runtime_error("Flags field overflow");
+                    Fail(kBadFormat, c);
+                } else {
+                    flags = f;
                 }
-                flags = f;
+            } else {
+                Fail(kBadFormat, c);
             }
             break;
         }
@@ -98,45 +183,66 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 negative = true;
                 state = State::spExprTime;
             } else if (c >= '0' && c <= '9') {
-                exprtime = (c - '0');
+                PushDigit(c);
                 state = State::spExprTime;
+            } else {
+                Fail(kBadFormat, c);
             }
             break;
         }
 
         case State::spExprTime: {
             if (c == ' ') {
-                state = State::spBytes;
-                // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
-            } else if (c >= '0' && c <= '9') {
-                int32_t et = exprtime;
-                if (negative) {
-                    et -= (c - '0');
-                    if (et > exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
+                if (NumberAsExpire(exprtime)) {
+                    number = 0;
+                    state = State::spBytes;
                 } else {
-                    et += (c - '0');
-                    if (et < exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
+                    Fail(kBadFormat, c);
                 }
-                exprtime = et;
+                // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
+            } else if (!PushDigit(c)) {
+                Fail(kBadFormat, c);
             }
             break;
         }
 
         case State::spBytes: {
-            if (c == '\r') {
+            if (c == '\r' && verb == vCas) {
+                // Version of the item is mandatory for cas
+                Fail(kBadFormat, c);
+            } else if (c == '\r') {
                 state = State::sLF;
                 // std::cout << "parser debug: bytes='" << bytes << "'" << std::endl;
+            } else if (c == ' ' && verb == vCas) {
+                state = State::spCasStart;
             } else if (c >= '0' && c <= '9') {
                 uint32_t b = (bytes * 10) + (c - '0');
                 if (b < bytes) {
                     // Overflow
-                    throw std::runtime_error("Bytes field overflow");
+                    Fail(kBadFormat, c);
+                } else {
+                    bytes = b;
                 }
-                bytes = b;
+            } else {
+                Fail(kBadFormat, c);
+            }
+            break;
+        }
+
+        case State::spCasStart: {
+            if (PushDigit(c)) {
+                state = State::spCas;
+            } else {
+                Fail(kBadFormat, c);
+            }
+            break;
+        }
+
+        case State::spCas: {
+            if (c == '\r') {
+                state = State::sLF;
+            } else if (!PushDigit(c)) {
+                Fail(kBadFormat, c);
             }
             break;
         }
@@ -145,54 +251,229 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
             if (c == '\n') {
                 parse_complete = true;
             } else {
-                std::stringstream err;
-                err << "Invalid char " << (int)c << " at position " << (parsed + pos) << ", \\n expected";
-                throw std::runtime_error(err.str());
+                Fail(kBadFormat, c);
+            }
+            break;
+        }
+
+        case State::sSkip: {
+            // Rest of the bad line is dropped at once
+            const char *lf = static_cast<const char *>(std::memchr(input + pos, '\n', size - pos));
+            if (lf != nullptr) {
+                pos = lf - input;
+                parse_complete = true;
+            } else {
+                pos = size - 1;
             }
             break;
         }
 
         default:
-            throw std::runtime_error("Unknown state");
+            Fail(kBadFormat, c);
         }
     }
 
     parsed += pos;
+
+    // Input goes away once call returns, unless command is ready to be built right now
+    if (!parse_complete) {
+        Spill();
+    }
     return parse_complete;
 }
 
 // See Parse.h
 std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
+    if (error != nullptr && parse_complete) {
+        body_size = 0;
+        return std::unique_ptr<Execute::Command>(new Execute::Error(error));
+    }
     if (state != State::sLF) {
         return std::unique_ptr<Execute::Command>(nullptr);
     }
 
-    body_size = bytes;
-    if (name == "set") {
-        return std::unique_ptr<Execute::Command>(new Execute::Set(keys[0], flags, exprtime));
-    } else if (name == "add") {
-        return std::unique_ptr<Execute::Command>(new Execute::Add(keys[0], flags, exprtime));
-    } else if (name == "append") {
-        return std::unique_ptr<Execute::Command>(new Execute::Append(keys[0], flags, exprtime));
-    } else if (name == "get") {
-        return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
-    } else if (name == "stats") {
-        return std::unique_ptr<Execute::Command>(new Execute::Stats());
-    } else {
-        throw std::runtime_error("Unsupported command");
-    }
+    // Builders are indexed by Verb, so command is picked without comparing its name once again
+    typedef Execute::Command *(*builder)(const Parser &p);
+    static const builder builders[vCount] = {
+        [](const Parser &p) -> Execute::Command * { return new Execute::Error(kUnknownCommand); },
+        [](const Parser &p) -> Execute::Command * {
+            return new Execute::Set(p.Str(p.keys[0]), p.flags, p.exprtime);
+        },
+        [](const Parser &p) -> Execute::Command * {
+            return new Execute::Add(p.Str(p.keys[0]), p.flags, p.exprtime);
+        },
+        [](const Parser &p) -> Execute::Command * {
+            return new Execute::Append(p.Str(p.keys[0]), p.flags, p.exprtime);
+        },
+        [](const Parser &p) -> Execute::Command * {
+            return new Execute::Prepend(p.Str(p.keys[0]), p.flags, p.exprtime);
+        },
+        [](const Parser &p) -> Execute::Command * {
+            return new Execute::Cas(p.Str(p.keys[0]), p.flags, p.exprtime, p.number);
+        },
+        [](const Parser &p) -> Execute::Command * { return new Execute::Get(p.Strs(p.keys)); },
+        [](const Parser &p) -> Execute::Command * { return new Execute::Gets(p.Strs(p.keys)); },
+        [](const Parser &p) -> Execute::Command * { return new Execute::Gat(p.exprtime, p.Strs(p.keys)); },
+        [](const Parser &p) -> Execute::Command * { return new Execute::Incr(p.Str(p.keys[0]), p.number); },
+        [](const Parser &p) -> Execute::Command * { return new Execute::Decr(p.Str(p.keys[0]), p.number); },
+        [](const Parser &p) -> Execute::Command * { return new Execute::Touch(p.Str(p.keys[0]), p.exprtime); },
+        [](const Parser &p) -> Execute::Command * {
+            return new Execute::Keys(p.keys.empty() ? std::string() : p.Str(p.keys[0]));
+        },
+        [](const Parser &p) -> Execute::Command * { return new Execute::Stats(); },
+    };
+
+    body_size = verb == vUnknown ? 0 : bytes;
+    return std::unique_ptr<Execute::Command>(builders[verb](*this));
 }
 
 // See Parse.h
 void Parser::Reset() {
     state = State::sName;
-    name.clear();
+    name = token{0, 0, false};
+    verb = vUnknown;
     keys.clear();
-    curKey.clear();
+    curKey = token{0, 0, false};
+    buffer = nullptr;
+    spill.clear();
     parse_complete = false;
     flags = 0;
     bytes = 0;
     exprtime = 0;
+    number = 0;
+    negative = false;
+    error = nullptr;
+}
+
+// See Parse.h
+Parser::Verb Parser::Lookup(const token &t) const {
+    // Longer name can't be a command, it even doesn't fit the packed form
+    if (t.size >= 8) {
+        return vUnknown;
+    }
+
+    const char *data = t.spilled ? &spill[t.offset] : buffer + t.offset;
+    uint64_t packed = uint64_t(t.size) << 56;
+    for (std::size_t i = 0; i < t.size; i++) {
+        packed |= uint64_t(uint8_t(data[i])) << (8 * i);
+    }
+
+    switch (packed) {
+    case Pack("set"):
+        return vSet;
+    case Pack("add"):
+        return vAdd;
+    case Pack("append"):
+        return vAppend;
+    case Pack("prepend"):
+        return vPrepend;
+    case Pack("cas"):
+        return vCas;
+    case Pack("get"):
+        return vGet;
+    case Pack("gets"):
+        return vGets;
+    case Pack("gat"):
+        return vGat;
+    case Pack("incr"):
+        return vIncr;
+    case Pack("decr"):
+        return vDecr;
+    case Pack("touch"):
+        return vTouch;
+    case Pack("keys"):
+        return vKeys;
+    case Pack("stats"):
+        return vStats;
+    default:
+        return vUnknown;
+    }
+}
+
+// See Parse.h
+bool Parser::PushDigit(char c) {
+    if (c < '0' || c > '9') {
+        return false;
+    }
+
+    uint64_t n = number * 10 + (c - '0');
+    if (number > UINT64_MAX / 10 || n < number * 10) {
+        return false;
+    }
+    number = n;
+    return true;
+}
+
+// See Parse.h
+bool Parser::NumberAsExpire(int32_t &expire) const {
+    if (number > (negative ? uint64_t(INT32_MAX) + 1 : uint64_t(INT32_MAX))) {
+        return false;
+    }
+    expire = negative ? int32_t(-int64_t(number)) : int32_t(number);
+    return true;
+}
+
+// See Parse.h
+void Parser::Fail(const char *reply, char c) {
+    error = reply;
+
+    // Bad char could be the end of the line itself, then there is nothing to skip
+    if (c == '\n') {
+        parse_complete = true;
+    } else {
+        state = State::sSkip;
+    }
+}
+
+// See Parse.h
+std::size_t Parser::Take(token &t, const char *input, std::size_t pos, std::size_t size) {
+    // Byte at the given position is taken anyway, state decided it is a part of the token
+    std::size_t stop = FindDelimiter(input + pos + 1, input + size) - input;
+    if (t.spilled) {
+        // Token started in one of the previous inputs, it is the last one in the spill buffer
+        spill.append(input + pos, stop - pos);
+    } else if (t.size == 0) {
+        t.offset = pos;
+    }
+    t.size += stop - pos;
+    return stop - 1;
+}
+
+// See Parse.h
+void Parser::Spill() {
+    Spill(name);
+    for (auto &key : keys) {
+        Spill(key);
+    }
+    Spill(curKey);
+}
+
+// See Parse.h
+void Parser::Spill(token &t) {
+    if (!t.spilled && t.size > 0) {
+        std::size_t offset = spill.size();
+        spill.append(buffer + t.offset, t.size);
+        t.offset = offset;
+        t.spilled = true;
+    }
+}
+
+// See Parse.h
+std::string Parser::Str(const token &t) const {
+    if (t.size == 0) {
+        return std::string();
+    }
+    return std::string(t.spilled ? &spill[t.offset] : buffer + t.offset, t.size);
+}
+
+// See Parse.h
+std::vector<std::string> Parser::Strs(const std::vector<token> &tokens) const {
+    std::vector<std::string> result;
+    result.reserve(tokens.size());
+    for (auto &t : tokens) {
+        result.push_back(Str(t));
+    }
+    return result;
 }
 
 } // namespace Protocol
@@ -20,6 +20,10 @@ namespace Protocol {
  */
 class Parser {
 public:
+    // Replies to the bad line
+    static constexpr const char *kUnknownCommand = "ERROR";
+    static constexpr const char *kBadFormat = "CLIENT_ERROR bad command line format";
+
     Parser() { Reset(); }
     /**
      * Push given string into parser input. Method returns true if it was a command parsed out
@@ -29,12 +33,23 @@ public:
      * @param parsed output parameter tells how many bytes was consumed from the string
      * @return true if command has been parsed out
      */
-    bool Parse(const std::string &input, size_t &parsed) { return Parse(&input[0], input.size(), parsed); }
+    bool Parse(const std::string &input, size_t &parsed) {
+        // String could be a temporary, so command gets its own copy of the tokens
+        bool result = Parse(&input[0], input.size(), parsed);
+        if (result) {
+            Spill();
+        }
+        return result;
+    }
 
     /**
      * Push given string into parser input. Method returns true if it was a command parsed out
      * from comulative input. In a such case method Build will return new command
      *
+     * Parser doesn't copy command name and keys, it remembers where they are in the input. So if method returns
+     * true, input must stay unchanged until Build is called. Tokens which are not complete by the end of input are
+     * copied into the parser own buffer, that is the only case parser touches heap
+     *
      * @param input string to be added to the parsed input
      * @param size number of bytes in the input buffer that could be read
      * @param parsed output parameter tells how many bytes was consumed from the string
@@ -53,7 +68,14 @@ public:
      */
     void Reset();
 
-    inline const std::string &Name() const { return name; }
+    inline std::string Name() const { return Str(name); }
+
+    /**
+     * Reply to the malformed line parsed out, nullptr if the line is fine. Parser never throws: the rest of the
+     * bad line is skipped up to \n, Parse returns true and Build gives out command which sends this reply. So
+     * connection keeps serving commands following the bad one
+     */
+    inline const char *Error() const { return error; }
 
 private:
     /**
@@ -61,15 +83,102 @@ private:
      * - s: state for PUT and GET commands
      * - sp: for PUT commands only
      * - sg: for GET commands only
+     * - sa: for commands having key and single numeric argument: incr, decr and touch
      */
-    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey };
+    enum State : uint16_t {
+        sCR,
+        sLF,
+        sName,
+        spKey,
+        spFlags,
+        spExprTimeStart,
+        spExprTime,
+        spBytes,
+        spCasStart,
+        spCas,
+        sgKey,
+        sgExprTime,
+        saKey,
+        saNumber,
+
+        // Bad line is skipped up to \n
+        sSkip
+    };
+
+    // Commands parser knows, order is the one of the builders table in Build
+    enum Verb : uint8_t {
+        vUnknown,
+        vSet,
+        vAdd,
+        vAppend,
+        vPrepend,
+        vCas,
+        vGet,
+        vGets,
+        vGat,
+        vIncr,
+        vDecr,
+        vTouch,
+        vKeys,
+        vStats,
+        vCount
+    };
+
+    // Command name packed into the integer: bytes go from the lowest one and the length is in the highest byte. All
+    // names are shorter than 8 bytes, so packing is unique and name is looked up by a single switch
+    static constexpr uint64_t Pack(const char *literal, std::size_t i = 0) {
+        return literal[i] == '\0' ? uint64_t(i) << 56
+                                  : uint64_t(uint8_t(literal[i])) << (8 * i) | Pack(literal, i + 1);
+    }
+
+    // Name or key in the command line: either in the current input at the given offset or in the spill buffer if
+    // it started in one of the previous inputs
+    struct token {
+        std::size_t offset;
+        std::size_t size;
+        bool spilled;
+    };
+
+    // Adds input byte at the given position and ones following it up to the next delimiter to the token, so token
+    // states don't go through the state switch for every char. Returns position of the last byte taken.
+    //
+    // Only command name and keys are taken this way. Numeric fields are at most 20 digits, so vector scan gives
+    // them nothing, and they are checked byte by byte by PushDigit: scan stops at ' ' and '\r' only, so a stray
+    // '\n' in the number would be taken into the token instead of ending the bad line
+    std::size_t Take(token &t, const char *input, std::size_t pos, std::size_t size);
+
+    // Copies tokens which still refer to the current input into the spill buffer
+    void Spill();
+    void Spill(token &t);
+
+    // Copy of the token bytes
+    std::string Str(const token &t) const;
+    std::vector<std::string> Strs(const std::vector<token> &tokens) const;
+
+    // Command the token names, vUnknown if there is no such command
+    Verb Lookup(const token &t) const;
+
+    // Accumulates next digit of the numeric argument, returns false if that is not a digit or number overflows.
+    // All numeric fields go through it, see Take above
+    bool PushDigit(char c);
+
+    // Numeric argument as an expiration time, returns false if it doesn't fit
+    bool NumberAsExpire(int32_t &expire) const;
+
+    // Marks the current line as bad one, the rest of it gets skipped. Char c is the one parser failed on
+    void Fail(const char *reply, char c);
 
     // Current parser state
     State state;
 
+    // Input of the current Parse call and bytes of tokens started in previous ones
+    const char *buffer;
+    std::string spill;
+
     // vrious fields of the command
-    std::string name;
-    std::vector<std::string> keys;
+    token name;
+    Verb verb;
+    std::vector<token> keys;
 
     // <flags> is an arbitrary 16-bit unsigned integer (written out in decimal) that the server stores along with
     // the data and sends back when the item is retrieved. Clients may use this as a bit field to store data-specific
@@ -88,9 +197,16 @@ private:
     // it's followed by an empty data block).
     uint32_t bytes;
 
+    // Numeric argument of incr, decr, touch and gat commands: delta or expiration time, sign is kept in negative.
+    // Version of the item for cas command. Expiration time of storage commands is accumulated here too
+    uint64_t number;
+
     bool negative;
-    std::string curKey;
+    token curKey;
     bool parse_complete;
+
+    // Reply to the bad line or nullptr
+    const char *error;
 };
 
 } // namespace Protocol
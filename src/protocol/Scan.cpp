@@ -0,0 +1,87 @@
+#include "Scan.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AFINA_SCAN_X86 1
+#endif
+
+namespace Afina {
+namespace Protocol {
+
+// See Scan.h
+const char *FindDelimiterScalar(const char *begin, const char *end) {
+    for (; begin != end; begin++) {
+        if (*begin == ' ' || *begin == '\r') {
+            break;
+        }
+    }
+    return begin;
+}
+
+#ifdef AFINA_SCAN_X86
+// See Scan.h
+__attribute__((target("sse4.2"))) const char *FindDelimiterSse42(const char *begin, const char *end) {
+    const __m128i delimiters = _mm_setr_epi8(' ', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    for (; end - begin >= 16; begin += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        int index = _mm_cmpestri(delimiters, 2, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY);
+        if (index < 16) {
+            return begin + index;
+        }
+    }
+    return FindDelimiterScalar(begin, end);
+}
+
+// See Scan.h
+__attribute__((target("avx2"))) const char *FindDelimiterAvx2(const char *begin, const char *end) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    for (; end - begin >= 32; begin += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        __m256i found = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, cr));
+        uint32_t mask = _mm256_movemask_epi8(found);
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+    return FindDelimiterScalar(begin, end);
+}
+#endif
+
+namespace {
+
+struct scanner {
+    const char *(*find)(const char *begin, const char *end);
+    const char *name;
+};
+
+scanner Select() {
+#ifdef AFINA_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return scanner{FindDelimiterAvx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return scanner{FindDelimiterSse42, "sse4.2"};
+    }
+#endif
+    return scanner{FindDelimiterScalar, "scalar"};
+}
+
+const scanner &Scanner() {
+    static const scanner selected = Select();
+    return selected;
+}
+
+} // namespace
+
+// See Scan.h
+const char *FindDelimiter(const char *begin, const char *end) { return Scanner().find(begin, end); }
+
+// See Scan.h
+const char *DelimiterScanName() { return Scanner().name; }
+
+} // namespace Protocol
+} // namespace Afina
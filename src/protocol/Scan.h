@@ -0,0 +1,35 @@
+#ifndef AFINA_PROTOCOL_SCAN_H
+#define AFINA_PROTOCOL_SCAN_H
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * Finds the first token delimiter, either ' ' or '\r', in the given range. Returns end if there is none.
+ *
+ * Range is checked 32 or 16 bytes at a time if CPU has AVX2 or SSE4.2, implementation is chosen once by CPUID,
+ * so binary built without those instructions enabled still uses them. Parser scans command names and keys this
+ * way, numeric fields are short and parsed byte by byte
+ */
+const char *FindDelimiter(const char *begin, const char *end);
+
+/**
+ * Name of the implementation FindDelimiter uses on this CPU: "avx2", "sse4.2" or "scalar"
+ */
+const char *DelimiterScanName();
+
+/**
+ * Implementations FindDelimiter chooses from, exposed for tests. Vector ones must be called only if CPU supports
+ * the instructions they are built for
+ */
+const char *FindDelimiterScalar(const char *begin, const char *end);
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse4.2"))) const char *FindDelimiterSse42(const char *begin, const char *end);
+__attribute__((target("avx2"))) const char *FindDelimiterAvx2(const char *begin, const char *end);
+#endif
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_SCAN_H
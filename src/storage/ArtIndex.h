@@ -0,0 +1,685 @@
+#ifndef AFINA_STORAGE_ART_INDEX_H
+#define AFINA_STORAGE_ART_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Adaptive radix tree index
+ * Ordered index of keys by their bytes. Inner node has one of 4 layouts depending on the number of children
+ * (4, 16, 48 or 256 of them), so sparse nodes stay small and dense ones are direct arrays. Chains of nodes with
+ * single child are collapsed into a prefix stored in the node, so keys sharing long prefixes (`user:123:...`)
+ * share the path instead of repeating it. Only first kMaxPrefix bytes of the prefix are kept in the node, the
+ * rest is checked against the key in the leaf.
+ *
+ * Leaves are pointers to items themselves tagged by the lowest bit, no memory is allocated per item and keys
+ * are not copied: index reaches the key through the item. Key ending in the middle of another one is kept in the
+ * terminal slot of the node where it ends. Traits type must provide:
+ * - const std::string &Key(const T *item) const: key of the item
+ *
+ * Items must be aligned at least by 2. That is NOT thread safe implementation!!
+ */
+template <typename T, typename Traits> class ArtIndex {
+public:
+    ArtIndex(Traits traits = Traits()) : _traits(traits), _root(0), _size(0), _bytes(0) {}
+    ~ArtIndex() { Clear(); }
+
+    /**
+     * Returns item with the given key or nullptr if there is no such key
+     */
+    T *Find(const std::string &key) const {
+        uintptr_t ref = _root;
+        std::size_t depth = 0;
+        while (ref != 0) {
+            if (IsLeaf(ref)) {
+                return _traits.Key(Leaf(ref)) == key ? Leaf(ref) : nullptr;
+            }
+
+            // Bytes of the long prefix which are not in the node get checked by the leaf comparison
+            inner *n = Inner(ref);
+            if (depth + n->prefix_len > key.size()) {
+                return nullptr;
+            }
+            for (std::size_t i = 0; i < std::min<std::size_t>(n->prefix_len, kMaxPrefix); i++) {
+                if (n->prefix[i] != uint8_t(key[depth + i])) {
+                    return nullptr;
+                }
+            }
+            depth += n->prefix_len;
+
+            if (depth == key.size()) {
+                return n->terminal != 0 && _traits.Key(Leaf(n->terminal)) == key ? Leaf(n->terminal) : nullptr;
+            }
+            uintptr_t *child = Child(n, key[depth]);
+            if (child == nullptr) {
+                return nullptr;
+            }
+            ref = *child;
+            depth++;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Adds item into the index, item having the same key gets replaced
+     */
+    void Insert(T *item) {
+        const std::string &key = _traits.Key(item);
+        uintptr_t *ref = &_root;
+        std::size_t depth = 0;
+        while (true) {
+            if (*ref == 0) {
+                *ref = MakeLeaf(item);
+                _size++;
+                return;
+            }
+
+            if (IsLeaf(*ref)) {
+                const std::string &other = _traits.Key(Leaf(*ref));
+                if (other == key) {
+                    *ref = MakeLeaf(item);
+                    return;
+                }
+
+                // Two keys diverge after common part, it becomes prefix of the new node
+                std::size_t common = 0;
+                while (depth + common < key.size() && depth + common < other.size() &&
+                       key[depth + common] == other[depth + common]) {
+                    common++;
+                }
+
+                node4 *n = New<node4>();
+                SetPrefix(n, key.data() + depth, common);
+                uintptr_t leaf = *ref;
+                *ref = reinterpret_cast<uintptr_t>(n);
+                Attach(*ref, n, other, depth + common, leaf);
+                Attach(*ref, n, key, depth + common, MakeLeaf(item));
+                _size++;
+                return;
+            }
+
+            inner *n = Inner(*ref);
+            std::size_t matched = Mismatch(*ref, key, depth);
+            if (matched < n->prefix_len) {
+                // Key diverges inside of the prefix: node is split at that point, its prefix loses matched bytes
+                // and the branching one
+                uint8_t branch;
+                std::size_t rest = n->prefix_len - matched - 1;
+                if (n->prefix_len <= kMaxPrefix) {
+                    branch = n->prefix[matched];
+                    std::memmove(n->prefix, n->prefix + matched + 1, rest);
+                } else {
+                    const std::string &full = _traits.Key(MinLeaf(*ref));
+                    branch = full[depth + matched];
+                    std::memcpy(n->prefix, full.data() + depth + matched + 1, std::min<std::size_t>(rest, kMaxPrefix));
+                }
+                n->prefix_len = rest;
+
+                node4 *parent = New<node4>();
+                SetPrefix(parent, key.data() + depth, matched);
+                parent->keys[0] = branch;
+                parent->children[0] = *ref;
+                parent->count = 1;
+                *ref = reinterpret_cast<uintptr_t>(parent);
+                Attach(*ref, parent, key, depth + matched, MakeLeaf(item));
+                _size++;
+                return;
+            }
+
+            depth += n->prefix_len;
+            if (depth == key.size()) {
+                _size += n->terminal == 0;
+                n->terminal = MakeLeaf(item);
+                return;
+            }
+
+            uintptr_t *child = Child(n, key[depth]);
+            if (child == nullptr) {
+                AddChild(*ref, n, key[depth], MakeLeaf(item));
+                _size++;
+                return;
+            }
+            ref = child;
+            depth++;
+        }
+    }
+
+    /**
+     * Removes item with the given key, returns false if there was no such key
+     */
+    bool Erase(const std::string &key) {
+        uintptr_t *ref = &_root;
+        std::size_t depth = 0;
+        while (*ref != 0) {
+            if (IsLeaf(*ref)) {
+                // Only the root could be a leaf here, deeper leaves are removed by their parent
+                if (_traits.Key(Leaf(*ref)) != key) {
+                    return false;
+                }
+                *ref = 0;
+                _size--;
+                return true;
+            }
+
+            inner *n = Inner(*ref);
+            if (Mismatch(*ref, key, depth) != n->prefix_len) {
+                return false;
+            }
+            depth += n->prefix_len;
+
+            if (depth == key.size()) {
+                if (n->terminal == 0 || _traits.Key(Leaf(n->terminal)) != key) {
+                    return false;
+                }
+                n->terminal = 0;
+                Compact(*ref);
+                _size--;
+                return true;
+            }
+
+            uintptr_t *child = Child(n, key[depth]);
+            if (child == nullptr) {
+                return false;
+            }
+            if (IsLeaf(*child)) {
+                if (_traits.Key(Leaf(*child)) != key) {
+                    return false;
+                }
+                RemoveChild(*ref, n, key[depth]);
+                _size--;
+                return true;
+            }
+            ref = child;
+            depth++;
+        }
+        return false;
+    }
+
+    /**
+     * Calls visit(item) for items which keys start with the given prefix in lexicographical order of keys until
+     * it returns false. Returns false if scan was stopped by visit
+     */
+    template <typename F> bool Scan(const std::string &prefix, F visit) const {
+        uintptr_t ref = _root;
+        std::size_t depth = 0;
+        while (ref != 0) {
+            if (IsLeaf(ref)) {
+                return !StartsWith(_traits.Key(Leaf(ref)), prefix) || visit(Leaf(ref));
+            }
+
+            inner *n = Inner(ref);
+            std::size_t len = std::min<std::size_t>(n->prefix_len, prefix.size() - depth);
+            for (std::size_t i = 0; i < std::min<std::size_t>(len, kMaxPrefix); i++) {
+                if (n->prefix[i] != uint8_t(prefix[depth + i])) {
+                    return true;
+                }
+            }
+
+            // All keys below share the path, so if one of them matches the prefix all others do
+            if (depth + n->prefix_len >= prefix.size()) {
+                return !StartsWith(_traits.Key(MinLeaf(ref)), prefix) || Walk(ref, visit);
+            }
+            depth += n->prefix_len;
+
+            uintptr_t *child = Child(n, prefix[depth]);
+            if (child == nullptr) {
+                return true;
+            }
+            ref = *child;
+            depth++;
+        }
+        return true;
+    }
+
+    void Clear() {
+        Free(_root);
+        _root = 0;
+        _size = 0;
+    }
+
+    // Number of items in the index
+    std::size_t Size() const { return _size; }
+
+    // Memory used by inner nodes
+    std::size_t Bytes() const { return _bytes; }
+
+private:
+    // Number of prefix bytes stored in the node itself
+    static constexpr std::size_t kMaxPrefix = 8;
+
+    enum node_type : uint8_t { kNode4, kNode16, kNode48, kNode256 };
+
+    struct inner {
+        explicit inner(node_type t) : type(t), count(0), prefix_len(0), terminal(0) {}
+
+        node_type type;
+
+        // Number of children, terminal is not counted
+        uint16_t count;
+
+        // Length of the whole prefix, only first kMaxPrefix bytes are stored
+        uint32_t prefix_len;
+        uint8_t prefix[kMaxPrefix];
+
+        // Leaf for the key ending right after the prefix
+        uintptr_t terminal;
+    };
+
+    // Keys are sorted, so children are in order
+    struct node4 : inner {
+        static constexpr node_type kType = kNode4;
+        static constexpr std::size_t kCapacity = 4;
+        node4() : inner(kType) {}
+
+        uint8_t keys[kCapacity];
+        uintptr_t children[kCapacity];
+    };
+
+    // Same as node4, but keys are matched all at once by SSE2
+    struct node16 : inner {
+        static constexpr node_type kType = kNode16;
+        static constexpr std::size_t kCapacity = 16;
+        node16() : inner(kType) {}
+
+        uint8_t keys[kCapacity];
+        uintptr_t children[kCapacity];
+    };
+
+    // Key byte gives position of the child plus one, zero means no child
+    struct node48 : inner {
+        static constexpr node_type kType = kNode48;
+        static constexpr std::size_t kCapacity = 48;
+        node48() : inner(kType) {
+            std::memset(index, 0, sizeof(index));
+            std::memset(children, 0, sizeof(children));
+        }
+
+        uint8_t index[256];
+        uintptr_t children[kCapacity];
+    };
+
+    struct node256 : inner {
+        static constexpr node_type kType = kNode256;
+        static constexpr std::size_t kCapacity = 256;
+        node256() : inner(kType) { std::memset(children, 0, sizeof(children)); }
+
+        uintptr_t children[kCapacity];
+    };
+
+    static bool IsLeaf(uintptr_t ref) { return (ref & 1) != 0; }
+    static T *Leaf(uintptr_t ref) { return reinterpret_cast<T *>(ref & ~uintptr_t(1)); }
+    static uintptr_t MakeLeaf(T *item) { return reinterpret_cast<uintptr_t>(item) | 1; }
+    static inner *Inner(uintptr_t ref) { return reinterpret_cast<inner *>(ref); }
+
+    static bool StartsWith(const std::string &key, const std::string &prefix) {
+        return key.size() >= prefix.size() && key.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    static void SetPrefix(inner *n, const char *data, std::size_t size) {
+        n->prefix_len = size;
+        std::memcpy(n->prefix, data, std::min(size, kMaxPrefix));
+    }
+
+    template <typename N> N *New() {
+        _bytes += sizeof(N);
+        return new N();
+    }
+
+    template <typename N> void Delete(inner *n) {
+        _bytes -= sizeof(N);
+        delete static_cast<N *>(n);
+    }
+
+    // Releases node with the whole subtree, items are not touched
+    void Free(uintptr_t ref) {
+        if (ref == 0 || IsLeaf(ref)) {
+            return;
+        }
+        inner *n = Inner(ref);
+        Children(n, [this](uint8_t, uintptr_t child) {
+            Free(child);
+            return true;
+        });
+        Release(n);
+    }
+
+    // Releases node itself
+    void Release(inner *n) {
+        switch (n->type) {
+        case kNode4:
+            Delete<node4>(n);
+            break;
+        case kNode16:
+            Delete<node16>(n);
+            break;
+        case kNode48:
+            Delete<node48>(n);
+            break;
+        case kNode256:
+            Delete<node256>(n);
+            break;
+        }
+    }
+
+    // Any leaf of the subtree, the one with smallest key
+    static T *MinLeaf(uintptr_t ref) {
+        while (!IsLeaf(ref)) {
+            inner *n = Inner(ref);
+            if (n->terminal != 0) {
+                return Leaf(n->terminal);
+            }
+            Children(n, [&ref](uint8_t, uintptr_t child) {
+                ref = child;
+                return false;
+            });
+        }
+        return Leaf(ref);
+    }
+
+    // Number of prefix bytes of the node matching the key starting from depth
+    std::size_t Mismatch(uintptr_t ref, const std::string &key, std::size_t depth) const {
+        inner *n = Inner(ref);
+        std::size_t len = std::min<std::size_t>(n->prefix_len, key.size() - depth);
+        std::size_t i = 0;
+        for (; i < std::min(len, kMaxPrefix); i++) {
+            if (n->prefix[i] != uint8_t(key[depth + i])) {
+                return i;
+            }
+        }
+        if (i < len) {
+            const std::string &full = _traits.Key(MinLeaf(ref));
+            for (; i < len; i++) {
+                if (full[depth + i] != key[depth + i]) {
+                    return i;
+                }
+            }
+        }
+        return len;
+    }
+
+    // Slot of the child for the given key byte or nullptr if there is no such child
+    static uintptr_t *Child(inner *n, uint8_t byte) {
+        switch (n->type) {
+        case kNode4: {
+            node4 *node = static_cast<node4 *>(n);
+            for (std::size_t i = 0; i < node->count; i++) {
+                if (node->keys[i] == byte) {
+                    return &node->children[i];
+                }
+            }
+            return nullptr;
+        }
+        case kNode16: {
+            node16 *node = static_cast<node16 *>(n);
+#if defined(__SSE2__)
+            __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i *>(node->keys));
+            uint32_t match = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(byte), keys));
+            match &= (uint32_t(1) << node->count) - 1;
+            return match != 0 ? &node->children[__builtin_ctz(match)] : nullptr;
+#else
+            for (std::size_t i = 0; i < node->count; i++) {
+                if (node->keys[i] == byte) {
+                    return &node->children[i];
+                }
+            }
+            return nullptr;
+#endif
+        }
+        case kNode48: {
+            node48 *node = static_cast<node48 *>(n);
+            return node->index[byte] != 0 ? &node->children[node->index[byte] - 1] : nullptr;
+        }
+        case kNode256: {
+            node256 *node = static_cast<node256 *>(n);
+            return node->children[byte] != 0 ? &node->children[byte] : nullptr;
+        }
+        }
+        return nullptr;
+    }
+
+    // Calls visit(byte, child) for children in order of their key bytes until it returns false
+    template <typename F> static bool Children(inner *n, F visit) {
+        switch (n->type) {
+        case kNode4:
+            return SortedChildren(static_cast<node4 *>(n), visit);
+        case kNode16:
+            return SortedChildren(static_cast<node16 *>(n), visit);
+        case kNode48: {
+            node48 *node = static_cast<node48 *>(n);
+            for (std::size_t b = 0; b < 256; b++) {
+                if (node->index[b] != 0 && !visit(uint8_t(b), node->children[node->index[b] - 1])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case kNode256: {
+            node256 *node = static_cast<node256 *>(n);
+            for (std::size_t b = 0; b < 256; b++) {
+                if (node->children[b] != 0 && !visit(uint8_t(b), node->children[b])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        }
+        return true;
+    }
+
+    template <typename N, typename F> static bool SortedChildren(N *node, F visit) {
+        for (std::size_t i = 0; i < node->count; i++) {
+            if (!visit(node->keys[i], node->children[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // In order traversal of the subtree
+    template <typename F> static bool Walk(uintptr_t ref, F &visit) {
+        if (IsLeaf(ref)) {
+            return visit(Leaf(ref));
+        }
+        inner *n = Inner(ref);
+        if (n->terminal != 0 && !visit(Leaf(n->terminal))) {
+            return false;
+        }
+        return Children(n, [&visit](uint8_t, uintptr_t child) { return Walk(child, visit); });
+    }
+
+    // Puts leaf of the key either into the terminal slot or under the key byte at depth
+    void Attach(uintptr_t &ref, inner *n, const std::string &key, std::size_t depth, uintptr_t leaf) {
+        if (depth == key.size()) {
+            n->terminal = leaf;
+        } else {
+            AddChild(ref, n, key[depth], leaf);
+        }
+    }
+
+    // Adds child for the byte which isn't there yet, full node is replaced by the larger one
+    void AddChild(uintptr_t &ref, inner *n, uint8_t byte, uintptr_t child) {
+        switch (n->type) {
+        case kNode4:
+            if (n->count < node4::kCapacity) {
+                return AddSorted(static_cast<node4 *>(n), byte, child);
+            }
+            n = Resize<node16>(ref, n);
+            return AddSorted(static_cast<node16 *>(n), byte, child);
+        case kNode16:
+            if (n->count < node16::kCapacity) {
+                return AddSorted(static_cast<node16 *>(n), byte, child);
+            }
+            n = Resize<node48>(ref, n);
+            return Add48(static_cast<node48 *>(n), byte, child);
+        case kNode48:
+            if (n->count < node48::kCapacity) {
+                return Add48(static_cast<node48 *>(n), byte, child);
+            }
+            n = Resize<node256>(ref, n);
+            return Add256(static_cast<node256 *>(n), byte, child);
+        case kNode256:
+            return Add256(static_cast<node256 *>(n), byte, child);
+        }
+    }
+
+    template <typename N> static void AddSorted(N *node, uint8_t byte, uintptr_t child) {
+        std::size_t pos = 0;
+        while (pos < node->count && node->keys[pos] < byte) {
+            pos++;
+        }
+        std::memmove(node->keys + pos + 1, node->keys + pos, node->count - pos);
+        std::memmove(node->children + pos + 1, node->children + pos, (node->count - pos) * sizeof(uintptr_t));
+        node->keys[pos] = byte;
+        node->children[pos] = child;
+        node->count++;
+    }
+
+    static void Add48(node48 *node, uint8_t byte, uintptr_t child) {
+        // Removals leave holes, so slot is searched for
+        std::size_t pos = 0;
+        while (node->children[pos] != 0) {
+            pos++;
+        }
+        node->children[pos] = child;
+        node->index[byte] = pos + 1;
+        node->count++;
+    }
+
+    static void Add256(node256 *node, uint8_t byte, uintptr_t child) {
+        node->children[byte] = child;
+        node->count++;
+    }
+
+    // Removes child for the byte, node gets shrunk or collapsed once it becomes sparse
+    void RemoveChild(uintptr_t &ref, inner *n, uint8_t byte) {
+        switch (n->type) {
+        case kNode4:
+            RemoveSorted(static_cast<node4 *>(n), byte);
+            break;
+        case kNode16:
+            RemoveSorted(static_cast<node16 *>(n), byte);
+            break;
+        case kNode48: {
+            node48 *node = static_cast<node48 *>(n);
+            node->children[node->index[byte] - 1] = 0;
+            node->index[byte] = 0;
+            node->count--;
+            break;
+        }
+        case kNode256:
+            static_cast<node256 *>(n)->children[byte] = 0;
+            n->count--;
+            break;
+        }
+        Compact(ref);
+    }
+
+    template <typename N> static void RemoveSorted(N *node, uint8_t byte) {
+        std::size_t pos = 0;
+        while (node->keys[pos] != byte) {
+            pos++;
+        }
+        std::memmove(node->keys + pos, node->keys + pos + 1, node->count - pos - 1);
+        std::memmove(node->children + pos, node->children + pos + 1, (node->count - pos - 1) * sizeof(uintptr_t));
+        node->count--;
+    }
+
+    // Replaces node by a smaller one if it has too few children. Node having the only child or the only terminal
+    // is merged into it. Thresholds are below capacities of smaller nodes, so that add/remove near the border
+    // doesn't resize node every time
+    void Compact(uintptr_t &ref) {
+        inner *n = Inner(ref);
+        switch (n->type) {
+        case kNode4:
+            if (n->count == 0) {
+                ref = n->terminal;
+                Release(n);
+            } else if (n->count == 1 && n->terminal == 0) {
+                Collapse(ref, static_cast<node4 *>(n));
+            }
+            break;
+        case kNode16:
+            if (n->count <= 3) {
+                Resize<node4>(ref, n);
+            }
+            break;
+        case kNode48:
+            if (n->count <= 12) {
+                Resize<node16>(ref, n);
+            }
+            break;
+        case kNode256:
+            if (n->count <= 37) {
+                Resize<node48>(ref, n);
+            }
+            break;
+        }
+    }
+
+    // Replaces node by its only child, prefix of the node and the key byte are prepended to the child prefix
+    void Collapse(uintptr_t &ref, node4 *n) {
+        uintptr_t child = n->children[0];
+        if (!IsLeaf(child)) {
+            inner *c = Inner(child);
+            uint8_t prefix[kMaxPrefix];
+            std::size_t len = std::min<std::size_t>(n->prefix_len, kMaxPrefix);
+            std::memcpy(prefix, n->prefix, len);
+            if (len < kMaxPrefix) {
+                prefix[len++] = n->keys[0];
+            }
+            std::size_t tail = std::min<std::size_t>(c->prefix_len, kMaxPrefix - len);
+            std::memcpy(prefix + len, c->prefix, tail);
+            std::memcpy(c->prefix, prefix, len + tail);
+            c->prefix_len += n->prefix_len + 1;
+        }
+        ref = child;
+        Release(n);
+    }
+
+    // Moves content of the node into a new one of the given type
+    template <typename N> N *Resize(uintptr_t &ref, inner *n) {
+        N *node = New<N>();
+        node->prefix_len = n->prefix_len;
+        std::memcpy(node->prefix, n->prefix, kMaxPrefix);
+        node->terminal = n->terminal;
+        Children(n, [this, node](uint8_t byte, uintptr_t child) {
+            Append(node, byte, child);
+            return true;
+        });
+        ref = reinterpret_cast<uintptr_t>(node);
+        Release(n);
+        return node;
+    }
+
+    // Children come in order, so sorted nodes just append
+    template <typename N> static void Append(N *node, uint8_t byte, uintptr_t child) {
+        node->keys[node->count] = byte;
+        node->children[node->count++] = child;
+    }
+    static void Append(node48 *node, uint8_t byte, uintptr_t child) { Add48(node, byte, child); }
+    static void Append(node256 *node, uint8_t byte, uintptr_t child) { Add256(node, byte, child); }
+
+    Traits _traits;
+
+    uintptr_t _root;
+
+    std::size_t _size;
+    std::size_t _bytes;
+};
+
+template <typename T, typename Traits> constexpr std::size_t ArtIndex<T, Traits>::kMaxPrefix;
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_ART_INDEX_H
@@ -0,0 +1,14 @@
+#include "BasicCache.h"
+
+namespace Afina {
+namespace Backend {
+
+// See BasicCache.h
+template class StorageAdapter<BasicCache<SwissIndexing, LruEviction, NoLock>>;
+template class StorageAdapter<BasicCache<SwissIndexing, LruEviction, std::mutex>>;
+template class StorageAdapter<BasicCache<SwissIndexing, ClockEviction, NoLock>>;
+template class StorageAdapter<BasicCache<SwissIndexing, ClockEviction, std::mutex>>;
+template class StorageAdapter<BasicCache<ArtIndexing, LruEviction, NoLock>>;
+
+} // namespace Backend
+} // namespace Afina
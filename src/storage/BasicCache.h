@@ -0,0 +1,583 @@
+#ifndef AFINA_STORAGE_BASIC_CACHE_H
+#define AFINA_STORAGE_BASIC_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "ArtIndex.h"
+#include "SwissIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Cache engine assembled from policies
+ * Index, eviction and locking are template parameters, so the whole operation is compiled as one piece without
+ * virtual calls between the parts. Policies are:
+ *
+ * Indexing::index<E>, index of entries by key:
+ * - E *Find(const std::string &key, std::size_t hash)
+ * - void Insert(E *entry, std::size_t hash), key must be absent
+ * - void Erase(const std::string &key, std::size_t hash)
+ * - bool Scan(const std::string &prefix, F visit), false if index isn't ordered
+ *
+ * Eviction::hook<E> is a base of the entry for policy data, Eviction::policy<E> decides what to evict:
+ * - void Add(E *entry), void Touch(E *entry), void Remove(E *entry)
+ * - E *Victim(), entry to be evicted next, cache is not empty
+ *
+ * Lock is anything having lock()/unlock(), NoLock for single threaded engine.
+ *
+ * Expired entries are invisible right away and get removed once touched or once eviction reaches them. Engine is
+ * not a Storage itself, see StorageAdapter below.
+ */
+template <typename Indexing, typename Eviction, typename Lock> class BasicCache {
+public:
+    using Value = Afina::Storage::Value;
+
+    explicit BasicCache(std::size_t max_size) : _max_size(max_size), _size(0), _last_version(0) {}
+
+    ~BasicCache() {
+        _index.Clear();
+        _eviction.Clear([](entry *e) { delete e; });
+    }
+
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) {
+        std::lock_guard<Lock> lock(_lock);
+        return Store(key, KeyHash(key), value, expire);
+    }
+
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        if (Alive(key, hash) != nullptr) {
+            return false;
+        }
+        return Store(key, hash, value, expire);
+    }
+
+    // Stores new value of the existing key, keeps expiration time unless keep_expire is false
+    bool Set(const std::string &key, const std::string &value, uint32_t expire, bool keep_expire) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        entry *e = Alive(key, hash);
+        if (e == nullptr) {
+            return false;
+        }
+        return Store(key, hash, value, keep_expire ? e->expire : expire);
+    }
+
+    bool Delete(const std::string &key) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        entry *e = _index.Find(key, hash);
+        if (e == nullptr) {
+            return false;
+        }
+
+        // Expired entry is removed anyway, but for the caller it was already absent
+        bool expired = Expired(*e, Now());
+        Remove(e, hash);
+        return !expired;
+    }
+
+    bool Get(const std::string &key, Value &value) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        entry *e = Alive(key, hash);
+        if (e == nullptr) {
+            return false;
+        }
+        _eviction.Touch(e);
+        value = e->value;
+        return true;
+    }
+
+    bool Get(const std::string &key, std::string &value) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        entry *e = Alive(key, hash);
+        if (e == nullptr) {
+            return false;
+        }
+        _eviction.Touch(e);
+        value = *e->value;
+        return true;
+    }
+
+    // Version gets the one given to the new value
+    template <typename F> bool Update(const std::string &key, F update, uint64_t &version) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        entry *e = Alive(key, hash);
+        std::string result;
+        if (e == nullptr || !update(*e->value, result) || !Store(key, hash, result, e->expire)) {
+            return false;
+        }
+        version = _last_version;
+        return true;
+    }
+
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        entry *e = Alive(key, hash);
+        if (e == nullptr) {
+            return false;
+        }
+        _eviction.Touch(e);
+        e->expire = expire;
+        value = e->value;
+        return true;
+    }
+
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        entry *e = Alive(key, hash);
+        if (e == nullptr) {
+            return false;
+        }
+        _eviction.Touch(e);
+        value = e->value;
+        version = e->version;
+        return true;
+    }
+
+    // Stores new value if the entry still has the given version, see Storage.h
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) {
+        std::size_t hash = KeyHash(key);
+        std::lock_guard<Lock> lock(_lock);
+        entry *e = Alive(key, hash);
+        if (e == nullptr || e->version != version) {
+            version = e == nullptr ? 0 : e->version;
+            return false;
+        }
+        if (!Store(key, hash, value, expire)) {
+            return false;
+        }
+        version = _last_version;
+        return true;
+    }
+
+    // Whole batch is looked up under single lock
+    std::size_t MultiGet(const std::string *keys, std::size_t count, Value *values) {
+        std::size_t result = 0;
+        std::lock_guard<Lock> lock(_lock);
+        for (std::size_t i = 0; i < count; i++) {
+            entry *e = Alive(keys[i], KeyHash(keys[i]));
+            if (e != nullptr) {
+                _eviction.Touch(e);
+                values[i] = e->value;
+                result++;
+            } else {
+                values[i].reset();
+            }
+        }
+        return result;
+    }
+
+    template <typename F> bool Scan(const std::string &prefix, F visit) {
+        std::lock_guard<Lock> lock(_lock);
+        uint32_t now = Now();
+        return _index.Scan(prefix, [&visit, now](entry *e) { return Expired(*e, now) || visit(e->key, e->value); });
+    }
+
+    void Stats(std::map<std::string, std::string> &stats) {
+        std::lock_guard<Lock> lock(_lock);
+        stats["cache_items"] = std::to_string(_index.Size());
+        stats["cache_items_bytes"] = std::to_string(_size);
+        stats["cache_limit_bytes"] = std::to_string(_max_size);
+    }
+
+private:
+    struct entry : Eviction::template hook<entry> {
+        entry(const std::string &k, Value v, uint32_t e, uint64_t ver)
+            : key(k), value(std::move(v)), expire(e), version(ver) {}
+
+        const std::string key;
+        Value value;
+
+        // Expiration time in seconds since epoch, 0 if entry never expires
+        uint32_t expire;
+
+        // Changes every time value gets replaced
+        uint64_t version;
+    };
+
+    static uint32_t Now() { return std::time(nullptr); }
+
+    static bool Expired(const entry &e, uint32_t now) { return e.expire != 0 && e.expire <= now; }
+
+    // Entry for the given key or nullptr if there is no such key or it is expired. Expired entry gets removed
+    entry *Alive(const std::string &key, std::size_t hash) {
+        entry *e = _index.Find(key, hash);
+        if (e != nullptr && Expired(*e, Now())) {
+            Remove(e, hash);
+            return nullptr;
+        }
+        return e;
+    }
+
+    bool Store(const std::string &key, std::size_t hash, const std::string &value, uint32_t expire) {
+        std::size_t entry_size = key.size() + value.size();
+        if (key.empty() || entry_size > _max_size) {
+            return false;
+        }
+
+        entry *e = _index.Find(key, hash);
+        if (e != nullptr) {
+            _size = _size - e->value->size() + value.size();
+            e->value = std::make_shared<const std::string>(value);
+            e->expire = expire;
+            e->version = ++_last_version;
+
+            // Entry must not be evicted in favor of its own new value
+            _eviction.Remove(e);
+            MakeRoom(0);
+            _eviction.Add(e);
+            return true;
+        }
+
+        MakeRoom(entry_size);
+        e = new entry(key, std::make_shared<const std::string>(value), expire, ++_last_version);
+        _index.Insert(e, hash);
+        _eviction.Add(e);
+        _size += entry_size;
+        return true;
+    }
+
+    // Evicts entries until there is a room for the given number of bytes
+    void MakeRoom(std::size_t bytes) {
+        while (_size + bytes > _max_size) {
+            entry *victim = _eviction.Victim();
+            Remove(victim, KeyHash(victim->key));
+        }
+    }
+
+    void Remove(entry *e, std::size_t hash) {
+        _index.Erase(e->key, hash);
+        _eviction.Remove(e);
+        _size -= e->key.size() + e->value->size();
+        delete e;
+    }
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be not greater than the _max_size
+    const std::size_t _max_size;
+    std::size_t _size;
+
+    // Version given to the last written value
+    uint64_t _last_version;
+
+    typename Indexing::template index<entry> _index;
+    typename Eviction::template policy<entry> _eviction;
+    Lock _lock;
+};
+
+/**
+ * Lock policy of the single threaded engine, compiles to nothing
+ */
+struct NoLock {
+    void lock() {}
+    void unlock() {}
+};
+
+/**
+ * Hash index policy, see SwissIndex.h
+ */
+struct SwissIndexing {
+    template <typename E> class index {
+    public:
+        E *Find(const std::string &key, std::size_t hash) {
+            E **it = _index.Find(key, hash);
+            return it == nullptr ? nullptr : *it;
+        }
+        void Insert(E *e, std::size_t hash) { _index.Insert(e, hash); }
+        void Erase(const std::string &key, std::size_t hash) { _index.Erase(key, hash); }
+        template <typename F> bool Scan(const std::string &, F) { return false; }
+        void Clear() { _index.Clear(); }
+        std::size_t Size() const { return _index.Size(); }
+
+    private:
+        struct traits {
+            std::size_t Hash(E *const &e) const { return KeyHash(e->key); }
+            bool Equal(E *const &e, const std::string &key) const { return e->key == key; }
+        };
+
+        SwissIndex<E *, traits> _index;
+    };
+};
+
+/**
+ * Ordered index policy, see ArtIndex.h. Hash is not used
+ */
+struct ArtIndexing {
+    template <typename E> class index {
+    public:
+        E *Find(const std::string &key, std::size_t) { return _index.Find(key); }
+        void Insert(E *e, std::size_t) { _index.Insert(e); }
+        void Erase(const std::string &key, std::size_t) { _index.Erase(key); }
+        template <typename F> bool Scan(const std::string &prefix, F visit) {
+            _index.Scan(prefix, visit);
+            return true;
+        }
+        void Clear() { _index.Clear(); }
+        std::size_t Size() const { return _index.Size(); }
+
+    private:
+        struct traits {
+            const std::string &Key(const E *e) const { return e->key; }
+        };
+
+        ArtIndex<E, traits> _index;
+    };
+};
+
+/**
+ * Least recently used entry is evicted. Entries form a list ordered by the last access, head is the oldest one
+ */
+struct LruEviction {
+    template <typename E> struct hook {
+        E *lru_prev = nullptr;
+        E *lru_next = nullptr;
+    };
+
+    template <typename E> class policy {
+    public:
+        policy() : _head(nullptr), _tail(nullptr) {}
+
+        void Add(E *e) {
+            e->lru_prev = _tail;
+            e->lru_next = nullptr;
+            if (_tail != nullptr) {
+                _tail->lru_next = e;
+            } else {
+                _head = e;
+            }
+            _tail = e;
+        }
+
+        void Touch(E *e) {
+            if (e != _tail) {
+                Remove(e);
+                Add(e);
+            }
+        }
+
+        void Remove(E *e) {
+            if (e->lru_prev != nullptr) {
+                e->lru_prev->lru_next = e->lru_next;
+            } else {
+                _head = e->lru_next;
+            }
+            if (e->lru_next != nullptr) {
+                e->lru_next->lru_prev = e->lru_prev;
+            } else {
+                _tail = e->lru_prev;
+            }
+        }
+
+        E *Victim() { return _head; }
+
+        // Gives all entries out to release, policy becomes empty
+        template <typename F> void Clear(F release) {
+            while (_head != nullptr) {
+                E *next = _head->lru_next;
+                release(_head);
+                _head = next;
+            }
+            _tail = nullptr;
+        }
+
+    private:
+        E *_head;
+        E *_tail;
+    };
+};
+
+/**
+ * CLOCK eviction: access only sets reference bit, hand walks over the ring of entries giving second chance to the
+ * referenced ones
+ */
+struct ClockEviction {
+    template <typename E> struct hook {
+        E *clock_prev = nullptr;
+        E *clock_next = nullptr;
+        bool referenced = false;
+    };
+
+    template <typename E> class policy {
+    public:
+        policy() : _hand(nullptr) {}
+
+        // New entry is placed right behind the hand, so it is checked last
+        void Add(E *e) {
+            e->referenced = false;
+            if (_hand == nullptr) {
+                e->clock_prev = e->clock_next = e;
+                _hand = e;
+                return;
+            }
+            e->clock_next = _hand;
+            e->clock_prev = _hand->clock_prev;
+            _hand->clock_prev->clock_next = e;
+            _hand->clock_prev = e;
+        }
+
+        void Touch(E *e) { e->referenced = true; }
+
+        void Remove(E *e) {
+            if (e->clock_next == e) {
+                _hand = nullptr;
+                return;
+            }
+            if (_hand == e) {
+                _hand = e->clock_next;
+            }
+            e->clock_prev->clock_next = e->clock_next;
+            e->clock_next->clock_prev = e->clock_prev;
+        }
+
+        E *Victim() {
+            while (_hand->referenced) {
+                _hand->referenced = false;
+                _hand = _hand->clock_next;
+            }
+            return _hand;
+        }
+
+        template <typename F> void Clear(F release) {
+            while (_hand != nullptr) {
+                E *e = _hand;
+                Remove(e);
+                release(e);
+            }
+        }
+
+    private:
+        E *_hand;
+    };
+};
+
+/**
+ * # Storage interface of the cache engine
+ * The only virtual layer between network and the engine: each method forwards to the engine, which is inlined
+ * into it completely
+ */
+template <typename Cache> class StorageAdapter final : public Afina::Storage {
+public:
+    StorageAdapter(size_t max_size = 1024) : _cache(max_size) {}
+    ~StorageAdapter() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override { return _cache.Put(key, value, 0); }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        return _cache.PutIfAbsent(key, value, 0);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override { return _cache.Set(key, value, 0, true); }
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override { return _cache.Delete(key); }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override { return _cache.Get(key, value); }
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, Value &value) override { return _cache.Get(key, value); }
+
+    // Implements Afina::Storage interface
+    std::size_t MultiGet(const std::string *keys, std::size_t count, Value *values) override {
+        return _cache.MultiGet(keys, count, values);
+    }
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) override {
+        return _cache.Put(key, value, expire);
+    }
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) override {
+        return _cache.PutIfAbsent(key, value, expire);
+    }
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t expire) override {
+        return _cache.Set(key, value, expire, false);
+    }
+
+    // Implements Afina::Storage interface
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update) override {
+        uint64_t version;
+        return _cache.Update(key, update, version);
+    }
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data, uint64_t &version) override {
+        return _cache.Update(key, Extender(data, false), version);
+    }
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data, uint64_t &version) override {
+        return _cache.Update(key, Extender(data, true), version);
+    }
+
+    // Implements Afina::Storage interface
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) override {
+        return _cache.GetAndTouch(key, expire, value);
+    }
+
+    // Implements Afina::Storage interface
+    bool Versioned() const override { return true; }
+
+    // Implements Afina::Storage interface
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) override {
+        return _cache.GetVersion(key, value, version);
+    }
+
+    // Implements Afina::Storage interface
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) override {
+        return _cache.CompareAndSet(key, value, expire, version);
+    }
+
+    // Implements Afina::Storage interface
+    bool Scan(const std::string &prefix,
+              const std::function<bool(const std::string &key, const Value &value)> &visit) override {
+        return _cache.Scan(prefix, visit);
+    }
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override { _cache.Stats(stats); }
+
+private:
+    Cache _cache;
+};
+
+// Engines selectable by --storage, instantiated once in BasicCache.cpp
+using BasicLRU = StorageAdapter<BasicCache<SwissIndexing, LruEviction, NoLock>>;
+using ThreadSafeBasicLRU = StorageAdapter<BasicCache<SwissIndexing, LruEviction, std::mutex>>;
+using BasicClock = StorageAdapter<BasicCache<SwissIndexing, ClockEviction, NoLock>>;
+using ThreadSafeBasicClock = StorageAdapter<BasicCache<SwissIndexing, ClockEviction, std::mutex>>;
+using BasicOrderedLRU = StorageAdapter<BasicCache<ArtIndexing, LruEviction, NoLock>>;
+
+extern template class StorageAdapter<BasicCache<SwissIndexing, LruEviction, NoLock>>;
+extern template class StorageAdapter<BasicCache<SwissIndexing, LruEviction, std::mutex>>;
+extern template class StorageAdapter<BasicCache<SwissIndexing, ClockEviction, NoLock>>;
+extern template class StorageAdapter<BasicCache<SwissIndexing, ClockEviction, std::mutex>>;
+extern template class StorageAdapter<BasicCache<ArtIndexing, LruEviction, NoLock>>;
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_BASIC_CACHE_H
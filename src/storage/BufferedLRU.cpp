@@ -0,0 +1,270 @@
+#include "BufferedLRU.h"
+
+#include <mutex>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+constexpr std::size_t BufferedLRU::kReadBuffers;
+constexpr uint32_t BufferedLRU::kReadBufferSize;
+constexpr uint32_t BufferedLRU::kDrainThreshold;
+
+namespace {
+
+// Sequential number of the current thread, used to spread threads over read buffers
+unsigned ThreadSlot() {
+    static std::atomic<unsigned> next(0);
+    static thread_local unsigned slot = next.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+} // namespace
+
+// See SimpleLRU.h
+bool BufferedLRU::Put(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Put(key, value);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::PutIfAbsent(key, value);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Set(const std::string &key, const std::string &value) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Set(key, value);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Delete(const std::string &key) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Delete(key);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Put(const std::string &key, const std::string &value, uint32_t expire) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Put(key, value, expire);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Put(const Key &key, const std::string &value, uint32_t expire) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Put(key, value, expire);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::PutIfAbsent(key, value, expire);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Set(const std::string &key, const std::string &value, uint32_t expire) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Set(key, value, expire);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Update(const std::string &key,
+                         const std::function<bool(const std::string &value, std::string &result)> &update) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Update(key, update);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Append(const std::string &key, const std::string &data, uint64_t &version) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Append(key, data, version);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Prepend(const std::string &key, const std::string &data, uint64_t &version) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::Prepend(key, data, version);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::GetAndTouch(const std::string &key, uint32_t expire, Value &value) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::GetAndTouch(key, expire, value);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::GetVersion(const std::string &key, Value &value, uint64_t &version) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::GetVersion(key, value, version);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::CompareAndSet(const std::string &key, const std::string &value, uint32_t expire,
+                                uint64_t &version) {
+    std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+    DrainReadBuffers();
+    return SimpleLRU::CompareAndSet(key, value, expire, version);
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Get(const std::string &key, std::string &value) {
+    // Value is copied out of the lock
+    Value shared;
+    if (!BufferedLRU::Get(key, shared)) {
+        return false;
+    }
+    value = *shared;
+    return true;
+}
+
+// See SimpleLRU.h
+bool BufferedLRU::Get(const std::string &key, Value &value) { return BufferedLRU::Get(Key(key), value); }
+
+// See SimpleLRU.h
+bool BufferedLRU::Get(const Key &key, Value &value) {
+    bool drain = false, chunked = true;
+    {
+        Concurrency::SharedLock<Concurrency::SharedMutex> lock(_lock);
+        // Expired node can't be removed under the shared lock, it is left for writers
+        lru_node *node = Lookup(key);
+        if (node == nullptr || Expired(*node, Now())) {
+            return false;
+        }
+        if (!node->chunks) {
+            value = node->value;
+            drain = RecordRead(node);
+            chunked = false;
+        }
+    }
+
+    // Value has appended chunks, they are joined under the exclusive lock
+    if (chunked) {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        DrainReadBuffers();
+        return SimpleLRU::Get(key, value);
+    }
+
+    // Somebody else is draining or writing right now, it will take care of our events
+    if (drain && _lock.try_lock()) {
+        DrainReadBuffers();
+        _lock.unlock();
+    }
+    return true;
+}
+
+// See SimpleLRU.h
+std::size_t BufferedLRU::MultiGet(const std::string *keys, std::size_t count, Value *values) {
+    std::vector<Key> refs;
+    refs.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        refs.emplace_back(keys[i]);
+    }
+    return BufferedLRU::MultiGet(refs.data(), count, values);
+}
+
+// See SimpleLRU.h
+std::size_t BufferedLRU::MultiGet(const Key *keys, std::size_t count, Value *values) {
+    std::vector<uint32_t> order(count);
+    for (std::size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    return BufferedLRU::MultiGet(keys, order.data(), count, values);
+}
+
+// See SimpleLRU.h
+std::size_t BufferedLRU::MultiGet(const Key *keys, const uint32_t *order, std::size_t count, Value *values) {
+    std::size_t result = 0;
+    bool drain = false;
+    std::vector<uint32_t> chunked;
+    {
+        Concurrency::SharedLock<Concurrency::SharedMutex> lock(_lock);
+        uint32_t now = Now();
+        for (std::size_t i = 0; i < count && i < kPrefetchDistance; i++) {
+            _lru_index.Prefetch(keys[order[i]].hash);
+        }
+
+        for (std::size_t i = 0; i < count; i++) {
+            if (i + kPrefetchDistance < count) {
+                _lru_index.Prefetch(keys[order[i + kPrefetchDistance]].hash);
+            }
+
+            uint32_t k = order[i];
+            lru_node *node = Lookup(keys[k]);
+            if (node != nullptr && !Expired(*node, now) && node->chunks) {
+                chunked.push_back(k);
+                values[k].reset();
+            } else if (node != nullptr && !Expired(*node, now)) {
+                values[k] = node->value;
+                drain = RecordRead(node) || drain;
+                result++;
+            } else {
+                values[k].reset();
+            }
+        }
+    }
+
+    // Values having appended chunks are joined under the exclusive lock
+    if (!chunked.empty()) {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        DrainReadBuffers();
+        for (uint32_t k : chunked) {
+            result += SimpleLRU::Get(keys[k], values[k]);
+        }
+        return result;
+    }
+
+    if (drain && _lock.try_lock()) {
+        DrainReadBuffers();
+        _lock.unlock();
+    }
+    return result;
+}
+
+// See BufferedLRU.h
+bool BufferedLRU::RecordRead(lru_node *node) {
+    read_buffer &buffer = _read_buffers[ThreadSlot() % kReadBuffers];
+
+    uint32_t head = buffer.head.load(std::memory_order_relaxed);
+    uint32_t pending = head - buffer.tail;
+    if (pending >= kReadBufferSize) {
+        return true;
+    }
+
+    // Lost race for the slot with another reader from the same group, just forget about the event
+    if (!buffer.head.compare_exchange_strong(head, head + 1, std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // Slot is published to the drainer by the lock release
+    buffer.nodes[head % kReadBufferSize] = node;
+    return pending + 1 >= kDrainThreshold;
+}
+
+// See BufferedLRU.h
+void BufferedLRU::DrainReadBuffers() {
+    // Nodes are deleted under exclusive lock only and always after drain, so all recorded nodes are alive
+    for (read_buffer &buffer : _read_buffers) {
+        uint32_t head = buffer.head.load(std::memory_order_relaxed);
+        for (; buffer.tail != head; buffer.tail++) {
+            Promote(*buffer.nodes[buffer.tail % kReadBufferSize]);
+        }
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
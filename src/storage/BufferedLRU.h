@@ -0,0 +1,122 @@
+#ifndef AFINA_STORAGE_BUFFERED_LRU_H
+#define AFINA_STORAGE_BUFFERED_LRU_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <afina/concurrency/SharedMutex.h>
+
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Thread safe LRU with deferred promotion
+ * Reads are done under the shared lock, so they never block each other. Instead of moving node to the tail
+ * right away, read puts node into the lossy ring buffer of its thread group. Buffers are drained and nodes
+ * get promoted in batches by whoever holds exclusive lock: each writer before the change and readers once
+ * buffer gets filled enough.
+ *
+ * In case if buffer is full, access event gets dropped: LRU order becomes approximate, but readers never wait
+ */
+class BufferedLRU : public SimpleLRU {
+public:
+    BufferedLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
+    ~BufferedLRU() {}
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key) override;
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value) override;
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, Value &value) override;
+
+    // see SimpleLRU.h
+    std::size_t MultiGet(const std::string *keys, std::size_t count, Value *values) override;
+
+    // see SimpleLRU.h
+    bool Get(const Key &key, Value &value) override;
+
+    // see SimpleLRU.h
+    std::size_t MultiGet(const Key *keys, std::size_t count, Value *values) override;
+
+    // see SimpleLRU.h
+    std::size_t MultiGet(const Key *keys, const uint32_t *order, std::size_t count, Value *values) override;
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // see SimpleLRU.h
+    bool Put(const Key &key, const std::string &value, uint32_t expire) override;
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // see SimpleLRU.h
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update) override;
+
+    // see SimpleLRU.h
+    bool Append(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // see SimpleLRU.h
+    bool Prepend(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // see SimpleLRU.h
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) override;
+
+    // see SimpleLRU.h
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) override;
+
+    // see SimpleLRU.h
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) override;
+
+private:
+    static constexpr std::size_t kReadBuffers = 16;
+    static constexpr uint32_t kReadBufferSize = 64;
+
+    // Number of pending events in the buffer after which reader tries to drain buffers
+    static constexpr uint32_t kDrainThreshold = kReadBufferSize / 2;
+
+    // Read events recorded by the group of threads. Readers reserve slots by moving head under the
+    // shared lock, tail gets moved only under exclusive lock
+    struct alignas(64) read_buffer {
+        read_buffer() : head(0), tail(0) {}
+
+        std::atomic<uint32_t> head;
+        uint32_t tail;
+        std::array<lru_node *, kReadBufferSize> nodes;
+    };
+
+    // Records read of the node, must be called under shared lock. Returns true if buffers should be drained
+    bool RecordRead(lru_node *node);
+
+    // Applies all recorded reads to the LRU order, must be called under exclusive lock
+    void DrainReadBuffers();
+
+    Concurrency::SharedMutex _lock;
+
+    std::array<read_buffer, kReadBuffers> _read_buffers;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_BUFFERED_LRU_H
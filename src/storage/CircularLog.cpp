@@ -0,0 +1,226 @@
+#include "CircularLog.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Afina {
+namespace Backend {
+
+constexpr std::size_t CircularLog::kSlots;
+constexpr std::size_t CircularLog::kItemSizeHint;
+constexpr std::size_t CircularLog::kReappendDivisor;
+constexpr uint64_t CircularLog::kOffsetMask;
+
+CircularLog::CircularLog(size_t max_size)
+    : _capacity(max_size), _log(new char[max_size]), _tail(0), _lost(0), _reappended(0) {
+    std::size_t buckets = 1;
+    while (buckets * kSlots * kItemSizeHint < 2 * _capacity) {
+        buckets *= 2;
+    }
+    _bucket_mask = buckets - 1;
+    _index.reset(new uint64_t[buckets * kSlots]());
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::Put(const std::string &key, const std::string &value) { return CircularLog::Put(key, value, 0); }
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::Put(const std::string &key, const std::string &value, uint32_t expire) {
+    if (key.empty() || ItemSize(key.size(), value.size()) > _capacity) {
+        return false;
+    }
+
+    std::size_t hash = KeyHash(key);
+    log_item item;
+    Append(key, hash, value.data(), value.size(), expire, Find(key, hash, item));
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::PutIfAbsent(const std::string &key, const std::string &value) {
+    return CircularLog::PutIfAbsent(key, value, 0);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) {
+    if (key.empty() || ItemSize(key.size(), value.size()) > _capacity) {
+        return false;
+    }
+
+    std::size_t hash = KeyHash(key);
+    log_item item;
+    uint64_t *slot = Find(key, hash, item);
+    if (slot != nullptr && (item.expire == 0 || item.expire > Now())) {
+        return false;
+    }
+    Append(key, hash, value.data(), value.size(), expire, slot);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::Set(const std::string &key, const std::string &value) {
+    std::size_t hash = KeyHash(key);
+    log_item item;
+    uint64_t *slot = Find(key, hash, item);
+    if (slot == nullptr || (item.expire != 0 && item.expire <= Now()) ||
+        ItemSize(key.size(), value.size()) > _capacity) {
+        return false;
+    }
+    Append(key, hash, value.data(), value.size(), item.expire, slot);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::Set(const std::string &key, const std::string &value, uint32_t expire) {
+    std::size_t hash = KeyHash(key);
+    log_item item;
+    uint64_t *slot = Find(key, hash, item);
+    if (slot == nullptr || (item.expire != 0 && item.expire <= Now()) ||
+        ItemSize(key.size(), value.size()) > _capacity) {
+        return false;
+    }
+    Append(key, hash, value.data(), value.size(), expire, slot);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::Delete(const std::string &key) {
+    log_item item;
+    uint64_t *slot = Find(key, KeyHash(key), item);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    // Item stays in the log until overwritten, but nothing refers to it anymore. Expired item was already
+    // absent for the caller
+    *slot = 0;
+    return item.expire == 0 || item.expire > Now();
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::Get(const std::string &key, std::string &value) {
+    std::size_t hash = KeyHash(key);
+    log_item item;
+    uint64_t *slot = Find(key, hash, item);
+    if (slot == nullptr) {
+        return false;
+    }
+    if (item.expire != 0 && item.expire <= Now()) {
+        *slot = 0;
+        return false;
+    }
+    value = Fetch(key, hash, slot, item);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CircularLog::Get(const std::string &key, Value &value) {
+    std::string copy;
+    if (!CircularLog::Get(key, copy)) {
+        return false;
+    }
+
+    // Log bytes get overwritten, so value handle always owns a copy
+    value = std::make_shared<const std::string>(std::move(copy));
+    return true;
+}
+
+// See Storage.h
+void CircularLog::Stats(std::map<std::string, std::string> &stats) {
+    stats["log_capacity_bytes"] = std::to_string(_capacity);
+    stats["log_written_bytes"] = std::to_string(_tail);
+    stats["log_index_slots"] = std::to_string((_bucket_mask + 1) * kSlots);
+    stats["log_lost_items"] = std::to_string(_lost);
+    stats["log_reappended_items"] = std::to_string(_reappended);
+}
+
+// See CircularLog.h
+uint64_t *CircularLog::Find(const std::string &key, std::size_t hash, log_item &item) {
+    uint16_t tag = Tag(hash);
+    uint64_t *bucket = Bucket(hash);
+    for (std::size_t i = 0; i < kSlots; i++) {
+        if (bucket[i] == 0 || SlotTag(bucket[i]) != tag || !Valid(SlotOffset(bucket[i]))) {
+            continue;
+        }
+
+        // Slot left untouched for 2^48 bytes of writes could point into the middle of some item, so the header
+        // is trusted only if the whole item is still in the log
+        uint64_t offset = Position(bucket[i]);
+        Read(offset, reinterpret_cast<char *>(&item), sizeof(item));
+        if (item.key_size == key.size() && ItemSize(item.key_size, item.value_size) <= Age(offset) &&
+            Equal(offset + sizeof(item), key)) {
+            return &bucket[i];
+        }
+    }
+    return nullptr;
+}
+
+// See CircularLog.h
+void CircularLog::Append(const std::string &key, std::size_t hash, const char *value, std::size_t value_size,
+                         uint32_t expire, uint64_t *slot) {
+    uint64_t offset = _tail;
+    log_item item{uint32_t(key.size()), uint32_t(value_size), expire, 0};
+    Write(offset, reinterpret_cast<const char *>(&item), sizeof(item));
+    Write(offset + sizeof(item), key.data(), key.size());
+    Write(offset + sizeof(item) + key.size(), value, value_size);
+    _tail += ItemSize(key.size(), value_size);
+
+    if (slot == nullptr) {
+        // Slot refers to overwritten item is as good as empty one, if there is none the oldest item is dropped
+        uint64_t *bucket = Bucket(hash);
+        for (std::size_t i = 0; i < kSlots; i++) {
+            if (bucket[i] == 0 || !Valid(SlotOffset(bucket[i]))) {
+                slot = &bucket[i];
+                break;
+            }
+            if (slot == nullptr || Age(SlotOffset(bucket[i])) > Age(SlotOffset(*slot))) {
+                slot = &bucket[i];
+            }
+        }
+        if (*slot != 0 && Valid(SlotOffset(*slot))) {
+            _lost++;
+        }
+    }
+    *slot = MakeSlot(Tag(hash), offset & kOffsetMask);
+}
+
+// See CircularLog.h
+std::string CircularLog::Fetch(const std::string &key, std::size_t hash, uint64_t *slot, const log_item &item) {
+    uint64_t offset = Position(*slot);
+    std::string value(item.value_size, '\0');
+    Read(offset + sizeof(item) + item.key_size, &value[0], value.size());
+
+    // Item being read is going to be overwritten soon, keep it at the fresh end of the log
+    if (_tail - offset > _capacity - _capacity / kReappendDivisor) {
+        Append(key, hash, value.data(), value.size(), item.expire, slot);
+        _reappended++;
+    }
+    return value;
+}
+
+// See CircularLog.h
+void CircularLog::Read(uint64_t offset, char *data, std::size_t size) const {
+    std::size_t pos = offset % _capacity;
+    std::size_t first = std::min(size, _capacity - pos);
+    std::memcpy(data, _log.get() + pos, first);
+    std::memcpy(data + first, _log.get(), size - first);
+}
+
+// See CircularLog.h
+void CircularLog::Write(uint64_t offset, const char *data, std::size_t size) {
+    std::size_t pos = offset % _capacity;
+    std::size_t first = std::min(size, _capacity - pos);
+    std::memcpy(_log.get() + pos, data, first);
+    std::memcpy(_log.get(), data + first, size - first);
+}
+
+// See CircularLog.h
+bool CircularLog::Equal(uint64_t offset, const std::string &key) const {
+    std::size_t pos = offset % _capacity;
+    std::size_t first = std::min(key.size(), _capacity - pos);
+    return std::memcmp(_log.get() + pos, key.data(), first) == 0 &&
+           std::memcmp(_log.get(), key.data() + first, key.size() - first) == 0;
+}
+
+} // namespace Backend
+} // namespace Afina
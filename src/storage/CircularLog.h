@@ -0,0 +1,153 @@
+#ifndef AFINA_STORAGE_CIRCULAR_LOG_H
+#define AFINA_STORAGE_CIRCULAR_LOG_H
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "SwissIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Circular log storage
+ * Items are appended one after another into the log of max_size bytes allocated once on construction: header,
+ * key bytes and value bytes. When the log wraps, new items overwrite the oldest ones, so eviction is FIFO by the
+ * log position and costs nothing. Put is a sequential copy, no memory is allocated per item.
+ *
+ * Index is lossy: buckets of kSlots slots each, slot keeps 16-bit tag of the key hash and low 48 bits of the log
+ * offset of the item. Log is much smaller than 2^48 bytes, so the full offset is restored from the distance to the
+ * log tail. Slot pointing to the overwritten part of the log is considered free. If bucket is full, the slot of
+ * the oldest item is reused and that item is lost even if it is still in the log. Key is verified against the
+ * log on every lookup, so tag collision never gives a wrong item.
+ *
+ * Item read from the older part of the log is appended again, so frequently used items survive wrap around.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class CircularLog : public Afina::Storage {
+public:
+    CircularLog(size_t max_size = 1024);
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, Value &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    // Slots per bucket, bucket takes one cache line
+    static constexpr std::size_t kSlots = 8;
+
+    // Expected average item size, index has twice as many slots as there are such items in the log
+    static constexpr std::size_t kItemSizeHint = 64;
+
+    // Items in the oldest part of the log of that fraction are appended again on hit
+    static constexpr std::size_t kReappendDivisor = 4;
+
+    static constexpr uint64_t kOffsetMask = (uint64_t(1) << 48) - 1;
+
+    // Item header in the log, key and value bytes follow it
+    struct log_item {
+        uint32_t key_size;
+        uint32_t value_size;
+
+        // Expiration time in seconds since epoch, 0 if item never expires
+        uint32_t expire;
+        uint32_t reserved;
+    };
+
+    // Slot of the index, zero if slot is empty
+    static uint64_t MakeSlot(uint16_t tag, uint64_t offset) { return (uint64_t(tag) << 48) | offset; }
+    static uint16_t SlotTag(uint64_t slot) { return slot >> 48; }
+    static uint64_t SlotOffset(uint64_t slot) { return slot & kOffsetMask; }
+
+    // Tag of the key hash, never zero
+    static uint16_t Tag(std::size_t hash) {
+        uint16_t tag = hash >> 48;
+        return tag == 0 ? 1 : tag;
+    }
+
+    static uint32_t Now() { return std::time(nullptr); }
+
+    static std::size_t ItemSize(std::size_t key_size, std::size_t value_size) {
+        return (sizeof(log_item) + key_size + value_size + 7) & ~std::size_t(7);
+    }
+
+    // Distance from the item at the given offset to the log tail. Offset could be either full or cut to 48 bits
+    uint64_t Age(uint64_t offset) const { return (_tail - offset) & kOffsetMask; }
+
+    // Full log offset of the item from the offset kept in the slot
+    uint64_t Position(uint64_t slot) const { return _tail - Age(SlotOffset(slot)); }
+
+    // Checks that item at the given log offset isn't overwritten yet: log keeps last capacity bytes written
+    bool Valid(uint64_t offset) const { return Age(offset) <= _capacity; }
+
+    // Slot of the given key, nullptr if there is no such key in the log. Header of the item is read out
+    uint64_t *Find(const std::string &key, std::size_t hash, log_item &item);
+
+    // Appends item into the log and points index to it, key must fit
+    void Append(const std::string &key, std::size_t hash, const char *value, std::size_t value_size, uint32_t expire,
+                uint64_t *slot);
+
+    // Copies bytes from/to logical log offset, handles wrap around
+    void Read(uint64_t offset, char *data, std::size_t size) const;
+    void Write(uint64_t offset, const char *data, std::size_t size);
+
+    // Compares log bytes at the offset with the key
+    bool Equal(uint64_t offset, const std::string &key) const;
+
+    // Value of the found item as a new buffer, re-appends the item if it is about to be overwritten
+    std::string Fetch(const std::string &key, std::size_t hash, uint64_t *slot, const log_item &item);
+
+    uint64_t *Bucket(std::size_t hash) { return &_index[(hash & _bucket_mask) * kSlots]; }
+
+    // Log buffer and its size
+    const std::size_t _capacity;
+    std::unique_ptr<char[]> _log;
+
+    // Logical offset the next item is written at, grows forever. Physical position is offset modulo capacity
+    uint64_t _tail;
+
+    // Index buckets
+    std::size_t _bucket_mask;
+    std::unique_ptr<uint64_t[]> _index;
+
+    // Number of valid items dropped from the index because their bucket was full
+    std::size_t _lost;
+    std::size_t _reappended;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CIRCULAR_LOG_H
@@ -0,0 +1,301 @@
+#include "CompactLRU.h"
+
+#include <algorithm>
+
+#include <afina/allocator/Error.h>
+
+namespace Afina {
+namespace Backend {
+
+constexpr uint32_t CompactLRU::kNil;
+constexpr uint32_t CompactLRU::kAgeRatio;
+
+// Page is big enough to hold plenty of small entries, but arena still has several pages to share between classes
+static std::size_t PageSize(std::size_t max_size) {
+    return std::min<std::size_t>(64 * 1024, std::max<std::size_t>(256, max_size / 8));
+}
+
+CompactLRU::CompactLRU(size_t max_size)
+    : _max_size(max_size), _size(0), _arena(new char[max_size]), _memory(_arena.get(), max_size),
+      _slab(_memory, PageSize(max_size)), _clock(0),
+      _index(compact_index_traits{&_entries}) {
+    _lru.resize(_slab.Classes().size() + 1, class_lru{kNil, kNil, 0, 0});
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CompactLRU::Put(const std::string &key, const std::string &value) {
+    if (key.empty()) {
+        return false;
+    }
+
+    std::size_t hash = KeyHash(key);
+    uint32_t *found = _index.Find(key, hash);
+    if (found == nullptr) {
+        return Insert(key, value, hash);
+    }
+
+    uint32_t id = *found;
+    entry *e = _entries[id];
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    // Entry stays in its chunk while the new size belongs to the same class, otherwise it moves to the new one.
+    // All links are ids so nothing else refers to the block. Moved entry already has the new size, so the old one
+    // is kept for accounting
+    std::size_t old_size = e->value_size;
+    Unlink(id);
+    if (_slab.ChunkSize(sizeof(entry) + key.size() + old_size) !=
+        _slab.ChunkSize(sizeof(entry) + key.size() + value.size())) {
+        // Entry is out of the list, so it never gets evicted here
+        entry *moved = Allocate(key.size(), value.size());
+        if (moved == nullptr) {
+            LinkTail(id);
+            Remove(id);
+            return false;
+        }
+
+        std::memcpy(moved->key(), e->key(), key.size());
+        _slab.free(e);
+        _entries[id] = e = moved;
+    }
+
+    _size = _size - old_size + value.size();
+    e->value_size = value.size();
+    std::memcpy(e->value(), value.data(), value.size());
+    LinkTail(id);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CompactLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    std::size_t hash = KeyHash(key);
+    if (key.empty() || _index.Find(key, hash) != nullptr) {
+        return false;
+    }
+    return Insert(key, value, hash);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CompactLRU::Set(const std::string &key, const std::string &value) {
+    if (_index.Find(key, KeyHash(key)) == nullptr) {
+        return false;
+    }
+    return CompactLRU::Put(key, value);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CompactLRU::Delete(const std::string &key) {
+    uint32_t *found = _index.Find(key, KeyHash(key));
+    if (found == nullptr) {
+        return false;
+    }
+    Remove(*found);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool CompactLRU::Get(const std::string &key, std::string &value) {
+    uint32_t *found = _index.Find(key, KeyHash(key));
+    if (found == nullptr) {
+        return false;
+    }
+
+    uint32_t id = *found;
+    entry *e = _entries[id];
+    value.assign(e->value(), e->value_size);
+    Unlink(id);
+    LinkTail(id);
+    _lru[ClassOf(e)].hits++;
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+void CompactLRU::Stats(std::map<std::string, std::string> &stats) {
+    stats["compact_items"] = std::to_string(_index.Size());
+    stats["compact_items_bytes"] = std::to_string(_size);
+    stats["compact_limit_bytes"] = std::to_string(_max_size);
+    stats["compact_slab_bytes"] = std::to_string(_slab.Footprint());
+
+    std::vector<Afina::Allocator::Slab::class_stats> classes = _slab.Classes();
+    for (std::size_t i = 0; i < classes.size(); i++) {
+        if (classes[i].pages == 0) {
+            continue;
+        }
+
+        std::string prefix = "slab_" + std::to_string(i) + "_";
+        stats[prefix + "chunk_size"] = std::to_string(classes[i].chunk_size);
+        stats[prefix + "pages"] = std::to_string(classes[i].pages);
+        stats[prefix + "used_chunks"] = std::to_string(classes[i].used_chunks);
+        stats[prefix + "total_chunks"] = std::to_string(classes[i].total_chunks);
+        stats[prefix + "hits"] = std::to_string(_lru[i].hits);
+        stats[prefix + "evicted"] = std::to_string(_lru[i].evicted);
+        stats[prefix + "age"] = std::to_string(Age(i));
+    }
+    stats["slab_large_items"] = std::to_string(_slab.LargeCount());
+    stats["slab_large_bytes"] = std::to_string(_slab.LargeBytes());
+    stats["slab_moved_pages"] = std::to_string(_slab.MovedPages());
+}
+
+// See CompactLRU.h
+CompactLRU::entry *CompactLRU::Allocate(std::size_t key_size, std::size_t value_size) {
+    std::size_t size = sizeof(entry) + key_size + value_size;
+    std::size_t klass = _slab.ClassOf(size);
+
+    void *block = nullptr;
+    while (block == nullptr) {
+        try {
+            block = _slab.alloc(size);
+        } catch (Afina::Allocator::AllocError &) {
+            if (!Evict(klass)) {
+                return nullptr;
+            }
+        }
+    }
+
+    entry *e = static_cast<entry *>(block);
+    e->prev = e->next = kNil;
+    e->key_size = key_size;
+    e->value_size = value_size;
+    e->touched = _clock;
+    return e;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Evict(std::size_t klass) {
+    std::size_t large = _lru.size() - 1;
+    std::size_t donor = Oldest(klass < large ? klass : _lru.size());
+    if (klass < large && _lru[klass].head != kNil) {
+        // Entry of the same class frees exactly the chunk needed. But if another class keeps entries unused for
+        // much longer, memory is in the wrong class and its page is taken instead
+        if (donor >= large || _slab.Pages(donor) < 2 || Age(klass) >= Age(donor) / kAgeRatio) {
+            EvictHead(klass);
+            return true;
+        }
+    }
+    if (donor == _lru.size()) {
+        return false;
+    }
+
+    // Page of the class holding the oldest entry goes to this class directly
+    if (klass < large && donor < large) {
+        if (!_slab.Move(donor, klass)) {
+            Drain(donor);
+        }
+        return true;
+    }
+
+    // Large entries need contiguous block, so evict until some memory gets back to the underlying allocator
+    std::size_t footprint = _slab.Footprint();
+    do {
+        EvictHead(donor);
+    } while (_slab.Footprint() == footprint && _lru[donor].head != kNil);
+    return true;
+}
+
+// See CompactLRU.h
+void CompactLRU::Drain(std::size_t klass) {
+    while (_slab.Moving(klass) && _lru[klass].head != kNil) {
+        EvictHead(klass);
+    }
+}
+
+// See CompactLRU.h
+void CompactLRU::EvictHead(std::size_t klass) {
+    _lru[klass].evicted++;
+    Remove(_lru[klass].head);
+}
+
+// See CompactLRU.h
+std::size_t CompactLRU::Oldest(std::size_t except) const {
+    std::size_t oldest = _lru.size();
+    for (std::size_t i = 0; i < _lru.size(); i++) {
+        if (i != except && _lru[i].head != kNil && (oldest == _lru.size() || Age(i) > Age(oldest))) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+// See CompactLRU.h
+uint32_t CompactLRU::Age(std::size_t klass) const {
+    uint32_t head = _lru[klass].head;
+    return head == kNil ? 0 : _clock - _entries[head]->touched;
+}
+
+// See CompactLRU.h
+bool CompactLRU::Insert(const std::string &key, const std::string &value, std::size_t hash) {
+    std::size_t entry_size = key.size() + value.size();
+    if (entry_size > _max_size) {
+        return false;
+    }
+
+    entry *e = Allocate(key.size(), value.size());
+    if (e == nullptr) {
+        return false;
+    }
+    std::memcpy(e->key(), key.data(), key.size());
+    std::memcpy(e->value(), value.data(), value.size());
+
+    uint32_t id;
+    if (!_free.empty()) {
+        id = _free.back();
+        _free.pop_back();
+        _entries[id] = e;
+    } else {
+        id = _entries.size();
+        _entries.push_back(e);
+    }
+
+    LinkTail(id);
+    _index.Insert(id, hash);
+    _size += entry_size;
+    return true;
+}
+
+// See CompactLRU.h
+void CompactLRU::Remove(uint32_t id) {
+    entry *e = _entries[id];
+    _index.Erase(key_ref{e->key(), e->key_size}, KeyHash(e->key(), e->key_size));
+    Unlink(id);
+
+    _size -= e->key_size + e->value_size;
+    _slab.free(e);
+    _entries[id] = nullptr;
+    _free.push_back(id);
+}
+
+// See CompactLRU.h
+void CompactLRU::Unlink(uint32_t id) {
+    entry *e = _entries[id];
+    class_lru &lru = _lru[ClassOf(e)];
+    if (e->prev != kNil) {
+        _entries[e->prev]->next = e->next;
+    } else {
+        lru.head = e->next;
+    }
+    if (e->next != kNil) {
+        _entries[e->next]->prev = e->prev;
+    } else {
+        lru.tail = e->prev;
+    }
+    e->prev = e->next = kNil;
+}
+
+// See CompactLRU.h
+void CompactLRU::LinkTail(uint32_t id) {
+    entry *e = _entries[id];
+    class_lru &lru = _lru[ClassOf(e)];
+    e->prev = lru.tail;
+    e->next = kNil;
+    e->touched = ++_clock;
+    if (lru.tail != kNil) {
+        _entries[lru.tail]->next = id;
+    } else {
+        lru.head = id;
+    }
+    lru.tail = id;
+}
+
+} // namespace Backend
+} // namespace Afina
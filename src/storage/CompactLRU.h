@@ -0,0 +1,175 @@
+#ifndef AFINA_STORAGE_COMPACT_LRU_H
+#define AFINA_STORAGE_COMPACT_LRU_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/allocator/Simple.h>
+#include <afina/allocator/Slab.h>
+
+#include "SwissIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Memory compact LRU
+ * Each entry is a single memory block: fixed header followed by key bytes and value bytes. Entries are
+ * addressed by 32-bit ids, which are positions in the entries table. LRU list links and index slots are ids as
+ * well, so per entry overhead is 20 bytes of header, 8 bytes of table and about 6 bytes of index.
+ *
+ * Blocks are slab chunks carved from the arena of max_size bytes allocated once on construction, so max_size
+ * bounds real memory used by entries including headers and rounding. Index and entries table are not part of the
+ * arena.
+ *
+ * Every slab class has its own LRU list, so new entry evicts the least recently used entry of the same size
+ * class, which frees exactly the chunk it needs. Unless the oldest entry of some other class is kAgeRatio times
+ * older: then that class is evicted until one of its pages gets free and the page is moved to the class in need.
+ * So memory follows shifts of the value sizes and ages of the oldest entries stay balanced between classes.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class CompactLRU : public Afina::Storage {
+public:
+    CompactLRU(size_t max_size = 1024);
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    // Id of no entry, terminates the LRU list
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    // Page is moved to the class if the oldest entry of another class is that many times older than its own
+    static constexpr uint32_t kAgeRatio = 2;
+
+    // Entry header, key and value bytes follow it in the same block
+    struct entry {
+        uint32_t prev;
+        uint32_t next;
+        uint32_t key_size;
+        uint32_t value_size;
+
+        // Logical time of the last use
+        uint32_t touched;
+
+        char *key() { return reinterpret_cast<char *>(this + 1); }
+        char *value() { return key() + key_size; }
+    };
+
+    // Key bytes stored somewhere else, allows to look up index without key copy
+    struct key_ref {
+        const char *data;
+        std::size_t size;
+    };
+
+    // Allows index to reach entry key by its id
+    struct compact_index_traits {
+        const std::vector<entry *> *entries;
+
+        std::size_t Hash(const uint32_t &id) const {
+            entry *e = (*entries)[id];
+            return KeyHash(e->key(), e->key_size);
+        }
+        bool Equal(const uint32_t &id, const std::string &key) const {
+            entry *e = (*entries)[id];
+            return e->key_size == key.size() && std::memcmp(e->key(), key.data(), key.size()) == 0;
+        }
+        bool Equal(const uint32_t &id, const key_ref &key) const {
+            entry *e = (*entries)[id];
+            return e->key_size == key.size && std::memcmp(e->key(), key.data, key.size) == 0;
+        }
+    };
+
+    // LRU list of the single slab class, large entries have a list of their own
+    struct class_lru {
+        uint32_t head;
+        uint32_t tail;
+
+        std::size_t hits;
+        std::size_t evicted;
+    };
+
+    // Allocates block for the entry of the given sizes evicting entries if needed, returns nullptr if cache has
+    // no room even being empty
+    entry *Allocate(std::size_t key_size, std::size_t value_size);
+
+    // Evicts entries so that allocation in the given class has a chance to succeed, false if there is nothing left
+    // to evict
+    bool Evict(std::size_t klass);
+
+    // Evicts entries of the class until the page requested to move gets free or class runs out of entries
+    void Drain(std::size_t klass);
+
+    // Removes the least recently used entry of the class
+    void EvictHead(std::size_t klass);
+
+    // Class holding the least recently used entry other than the given one, _lru.size() if there is none. Passing
+    // _lru.size() considers all classes
+    std::size_t Oldest(std::size_t except) const;
+
+    // Time passed since the least recently used entry of the class was used, 0 if class is empty
+    uint32_t Age(std::size_t klass) const;
+
+    // Slab class of the entry, number of classes for large ones
+    std::size_t ClassOf(const entry *e) const { return _slab.ClassOf(sizeof(entry) + e->key_size + e->value_size); }
+
+    // Puts new entry, key must be absent
+    bool Insert(const std::string &key, const std::string &value, std::size_t hash);
+
+    // Releases entry with the given id
+    void Remove(uint32_t id);
+
+    // LRU list manipulation, entry goes to the list of its class
+    void Unlink(uint32_t id);
+    void LinkTail(uint32_t id);
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all entries blocks with headers must be not greater than the _max_size
+    std::size_t _max_size;
+
+    // Total size of keys and values
+    std::size_t _size;
+
+    // Memory of all entries
+    std::unique_ptr<char[]> _arena;
+    Afina::Allocator::Simple _memory;
+    Afina::Allocator::Slab _slab;
+
+    // Entries table, entry id is position in it. Free ids have nullptr
+    std::vector<entry *> _entries;
+    std::vector<uint32_t> _free;
+
+    // LRU lists of entries ids per slab class, head is the least recently used one
+    std::vector<class_lru> _lru;
+
+    // Logical time, advances on every use of entry
+    uint32_t _clock;
+
+    // Index of entries ids
+    SwissIndex<uint32_t, compact_index_traits> _index;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_COMPACT_LRU_H
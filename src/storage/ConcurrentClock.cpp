@@ -0,0 +1,263 @@
+#include "ConcurrentClock.h"
+
+#include <ctime>
+#include <memory>
+
+namespace Afina {
+namespace Backend {
+
+ConcurrentClock::ConcurrentClock(size_t max_size)
+    : _max_size(max_size), _size(0), _last_version(0), _evicted(0), _expired(0) {}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::Put(const std::string &key, const std::string &value) {
+    return Store(key, value, 0, store_mode::kAny, false);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::PutIfAbsent(const std::string &key, const std::string &value) {
+    return Store(key, value, 0, store_mode::kAbsent, false);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::Set(const std::string &key, const std::string &value) {
+    return Store(key, value, 0, store_mode::kPresent, true);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::Put(const std::string &key, const std::string &value, uint32_t expire) {
+    return Store(key, value, expire, store_mode::kAny, false);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) {
+    return Store(key, value, expire, store_mode::kAbsent, false);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::Set(const std::string &key, const std::string &value, uint32_t expire) {
+    return Store(key, value, expire, store_mode::kPresent, false);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::Delete(const std::string &key) {
+    uint32_t now = Now();
+    bool expired = false;
+    std::size_t bytes = 0;
+    bool erased = _map.Erase(key, [&](const clock_entry &entry) {
+        expired = Expired(entry, now);
+        bytes = key.size() + entry.value->size();
+        return true;
+    });
+
+    if (!erased) {
+        return false;
+    }
+    _size.fetch_sub(bytes, std::memory_order_relaxed);
+
+    // Expired entry is removed anyway, but for the caller it was already absent
+    return !expired;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::Get(const std::string &key, std::string &value) {
+    Value handle;
+    if (!ConcurrentClock::Get(key, handle)) {
+        return false;
+    }
+    value = *handle;
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ConcurrentClock::Get(const std::string &key, Value &value) {
+    clock_entry entry;
+    if (!_map.Find(key, entry) || Expired(entry, Now())) {
+        return false;
+    }
+    value = std::move(entry.value);
+    return true;
+}
+
+// See Storage.h
+bool ConcurrentClock::Update(const std::string &key,
+                             const std::function<bool(const std::string &value, std::string &result)> &update) {
+    uint64_t version;
+    return Update(key, update, version);
+}
+
+// See Storage.h
+bool ConcurrentClock::Append(const std::string &key, const std::string &data, uint64_t &version) {
+    return Update(key, Extender(data, false), version);
+}
+
+// See Storage.h
+bool ConcurrentClock::Prepend(const std::string &key, const std::string &data, uint64_t &version) {
+    return Update(key, Extender(data, true), version);
+}
+
+// See ConcurrentClock.h
+bool ConcurrentClock::Update(const std::string &key,
+                             const std::function<bool(const std::string &value, std::string &result)> &update,
+                             uint64_t &version) {
+    // New value is built under the stripe lock, so concurrent updates of the key never get lost
+    uint32_t now = Now();
+    std::size_t freed = 0, added = 0;
+    bool stored = _map.Update(key, [&](const clock_entry *old, clock_entry &entry) {
+        std::string result;
+        if (old == nullptr || Expired(*old, now) || !update(*old->value, result) ||
+            key.size() + result.size() > _max_size) {
+            return false;
+        }
+
+        freed = old->value->size();
+        added = result.size();
+        entry.value = std::make_shared<const std::string>(std::move(result));
+        entry.expire = old->expire;
+        entry.version = version = NextVersion();
+        return true;
+    });
+
+    if (!stored) {
+        return false;
+    }
+    _size.fetch_add(added - freed, std::memory_order_relaxed);
+    Shrink(now);
+    return true;
+}
+
+// See Storage.h
+bool ConcurrentClock::GetAndTouch(const std::string &key, uint32_t expire, Value &value) {
+    uint32_t now = Now();
+    Value current;
+    bool touched = _map.Update(key, [&](const clock_entry *old, clock_entry &entry) {
+        if (old == nullptr || Expired(*old, now)) {
+            return false;
+        }
+        entry.value = current = old->value;
+        entry.expire = expire;
+        entry.version = old->version;
+        return true;
+    });
+
+    if (!touched) {
+        return false;
+    }
+    value = std::move(current);
+    return true;
+}
+
+// See Storage.h
+bool ConcurrentClock::GetVersion(const std::string &key, Value &value, uint64_t &version) {
+    clock_entry entry;
+    if (!_map.Find(key, entry) || Expired(entry, Now())) {
+        return false;
+    }
+    value = std::move(entry.value);
+    version = entry.version;
+    return true;
+}
+
+// See Storage.h
+bool ConcurrentClock::CompareAndSet(const std::string &key, const std::string &value, uint32_t expire,
+                                    uint64_t &version) {
+    if (key.empty() || key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    // Version is checked under the stripe lock, so nobody could write the key in between
+    Value shared = std::make_shared<const std::string>(value);
+    uint32_t now = Now();
+    uint64_t expected = version;
+    std::size_t freed = 0;
+    bool stored = _map.Update(key, [&](const clock_entry *old, clock_entry &entry) {
+        bool alive = old != nullptr && !Expired(*old, now);
+        version = alive ? old->version : 0;
+        if (!alive || old->version != expected) {
+            return false;
+        }
+
+        entry.value = shared;
+        entry.expire = expire;
+        entry.version = version = NextVersion();
+        freed = key.size() + old->value->size();
+        return true;
+    });
+
+    if (!stored) {
+        return false;
+    }
+    _size.fetch_add(key.size() + value.size() - freed, std::memory_order_relaxed);
+    Shrink(now);
+    return true;
+}
+
+// See Storage.h
+void ConcurrentClock::Stats(std::map<std::string, std::string> &stats) {
+    stats["concurrent_items"] = std::to_string(_map.Size());
+    stats["concurrent_items_bytes"] = std::to_string(_size.load(std::memory_order_relaxed));
+    stats["concurrent_limit_bytes"] = std::to_string(_max_size);
+    stats["concurrent_buckets"] = std::to_string(_map.Buckets());
+    stats["concurrent_evicted"] = std::to_string(_evicted.load(std::memory_order_relaxed));
+    stats["concurrent_expired"] = std::to_string(_expired.load(std::memory_order_relaxed));
+}
+
+// See ConcurrentClock.h
+bool ConcurrentClock::Store(const std::string &key, const std::string &value, uint32_t expire, store_mode mode,
+                            bool keep_expire) {
+    if (key.empty() || key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    // Value is built before the stripe lock is taken
+    Value shared = std::make_shared<const std::string>(value);
+    uint32_t now = Now();
+    std::size_t freed = 0;
+    bool stored = _map.Update(key, [&](const clock_entry *old, clock_entry &entry) {
+        bool alive = old != nullptr && !Expired(*old, now);
+        if ((mode == store_mode::kAbsent && alive) || (mode == store_mode::kPresent && !alive)) {
+            return false;
+        }
+
+        entry.value = shared;
+        entry.expire = keep_expire ? old->expire : expire;
+        entry.version = NextVersion();
+        freed = old == nullptr ? 0 : key.size() + old->value->size();
+        return true;
+    });
+
+    if (!stored) {
+        return false;
+    }
+    _size.fetch_add(key.size() + value.size() - freed, std::memory_order_relaxed);
+    Shrink(now);
+    return true;
+}
+
+// See ConcurrentClock.h
+void ConcurrentClock::Shrink(uint32_t now) {
+    while (_size.load(std::memory_order_relaxed) > _max_size) {
+        std::size_t bytes = 0;
+        bool evicted = _map.Evict([&](const std::string &key, const clock_entry &entry, bool referenced) {
+            bool expired = Expired(entry, now);
+            if (!expired && referenced) {
+                return false;
+            }
+
+            (expired ? _expired : _evicted).fetch_add(1, std::memory_order_relaxed);
+            bytes = key.size() + entry.value->size();
+            return true;
+        });
+
+        if (!evicted) {
+            break;
+        }
+        _size.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+}
+
+// See ConcurrentClock.h
+uint32_t ConcurrentClock::Now() { return static_cast<uint32_t>(std::time(nullptr)); }
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,128 @@
+#ifndef AFINA_STORAGE_CONCURRENT_CLOCK_H
+#define AFINA_STORAGE_CONCURRENT_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "ConcurrentHashMap.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK eviction on top of the concurrent hash map
+ * Get never locks: it reads the map inside of epoch critical section and sets the entry reference bit. Writes lock
+ * only the stripe of their key, so there is no global lock and map resize never stops the world. Victims are found
+ * by the clock hand sweeping over map buckets, expired entries are evicted first, the rest get a second chance
+ * if they were read since the previous sweep.
+ *
+ * Expired entries are never returned, but they are removed lazily: by Delete, by overwrite or by eviction.
+ */
+class ConcurrentClock : public Afina::Storage {
+public:
+    ConcurrentClock(size_t max_size = 1024);
+    ~ConcurrentClock() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, Value &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) override;
+
+    // Implements Afina::Storage interface
+    bool Versioned() const override { return true; }
+
+    // Implements Afina::Storage interface
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    struct clock_entry {
+        Value value;
+        uint32_t expire;
+
+        // Changes every time value gets replaced
+        uint64_t version;
+    };
+
+    // Which state of the key allows Store to write it
+    enum class store_mode { kAny, kAbsent, kPresent };
+
+    // Writes value if key state matches the mode, expiration time is kept as is if keep_expire is set
+    bool Store(const std::string &key, const std::string &value, uint32_t expire, store_mode mode,
+               bool keep_expire);
+
+    // Same as Update, version gets the one given to the new value
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update,
+                uint64_t &version);
+
+    // Evicts entries until cache fits into its limit
+    void Shrink(uint32_t now);
+
+    uint64_t NextVersion() { return _last_version.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+    static uint32_t Now();
+    static bool Expired(const clock_entry &entry, uint32_t now) { return entry.expire != 0 && entry.expire <= now; }
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be not greater than the _max_size
+    const std::size_t _max_size;
+    std::atomic<std::size_t> _size;
+
+    // Version given to the last written value
+    std::atomic<uint64_t> _last_version;
+
+    std::atomic<std::size_t> _evicted;
+    std::atomic<std::size_t> _expired;
+
+    ConcurrentHashMap<clock_entry> _map;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CONCURRENT_CLOCK_H
@@ -0,0 +1,343 @@
+#ifndef AFINA_STORAGE_CONCURRENT_HASH_MAP_H
+#define AFINA_STORAGE_CONCURRENT_HASH_MAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <afina/concurrency/Epoch.h>
+
+#include "SwissIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Concurrent hash map with incremental resize
+ * Separate chaining table. Readers never lock: they traverse chains inside of epoch critical section, nodes are
+ * immutable, so an update replaces the whole node and old one is retired. Writers lock one of the stripes
+ * selected by the low bits of the key hash.
+ *
+ * Table grows by doubling, but buckets are moved to the new table incrementally: each write moves a few of them
+ * after its own work is done. Moved bucket of the old table gets the forwarding marker, so readers and writers
+ * reaching it continue in the new table. Number of stripes divides table size, so bucket of the old table and
+ * both its halves in the new one are protected by the same stripe. There is no moment when the whole table is
+ * locked.
+ *
+ * Each node has a reference bit set by readers, so map could be swept by CLOCK hand for eviction.
+ */
+template <typename V> class ConcurrentHashMap {
+public:
+    explicit ConcurrentHashMap(std::size_t capacity = 0) : _count(0), _hand(0) {
+        std::size_t size = kStripes;
+        while (size < capacity) {
+            size *= 2;
+        }
+        _table.store(new table(size), std::memory_order_release);
+    }
+
+    ~ConcurrentHashMap() {
+        // No concurrent access is possible anymore, so everything could be released right away
+        for (table *t = _table.load(std::memory_order_relaxed); t != nullptr;) {
+            for (std::size_t b = 0; b <= t->mask; b++) {
+                node *n = t->buckets[b].load(std::memory_order_relaxed);
+                while (n != nullptr && n != Moved()) {
+                    node *next = n->next.load(std::memory_order_relaxed);
+                    delete n;
+                    n = next;
+                }
+            }
+            table *next = t->next.load(std::memory_order_relaxed);
+            delete t;
+            t = next;
+        }
+    }
+
+    /**
+     * Copies value for the given key out, returns false if there is no such key. Never blocks
+     */
+    bool Find(const std::string &key, V &value) {
+        std::size_t hash = KeyHash(key);
+        Concurrency::Epoch::Guard guard;
+
+        table *t = _table.load(std::memory_order_acquire);
+        node *n;
+        while ((n = t->buckets[hash & t->mask].load(std::memory_order_acquire)) == Moved()) {
+            t = t->next.load(std::memory_order_acquire);
+        }
+
+        for (; n != nullptr; n = n->next.load(std::memory_order_acquire)) {
+            if (n->hash == hash && n->key == key) {
+                // Avoid writing shared cache line when bit is already set
+                if (!n->referenced.load(std::memory_order_relaxed)) {
+                    n->referenced.store(true, std::memory_order_relaxed);
+                }
+                value = n->value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Atomically changes value of the key. Calls update(old, value) under the key lock, where old is the
+     * current value or nullptr if key is absent. If update returns true key gets associated with value,
+     * otherwise map stays unchanged. Returns result of update
+     */
+    template <typename F> bool Update(const std::string &key, F update) {
+        std::size_t hash = KeyHash(key);
+        bool result;
+        {
+            std::lock_guard<std::mutex> lock(Stripe(hash));
+            Concurrency::Epoch::Guard guard;
+
+            std::atomic<node *> *link = &Bucket(hash);
+            node *n = link->load(std::memory_order_relaxed);
+            for (; n != nullptr && (n->hash != hash || n->key != key); n = n->next.load(std::memory_order_relaxed)) {
+                link = &n->next;
+            }
+
+            V value;
+            result = update(n == nullptr ? nullptr : &n->value, value);
+            if (result) {
+                node *next = n == nullptr ? nullptr : n->next.load(std::memory_order_relaxed);
+                node *replacement = new node(key, hash, std::move(value), next);
+                if (n != nullptr) {
+                    replacement->referenced.store(n->referenced.load(std::memory_order_relaxed),
+                                                  std::memory_order_relaxed);
+                }
+                link->store(replacement, std::memory_order_release);
+                if (n != nullptr) {
+                    Concurrency::Epoch::Retire(n);
+                } else {
+                    _count.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        if (result) {
+            Grow();
+        }
+        Migrate();
+        return result;
+    }
+
+    /**
+     * Removes key if erase(value) returns true for its current value. Returns false if key is absent or it is
+     * left in place
+     */
+    template <typename F> bool Erase(const std::string &key, F erase) {
+        std::size_t hash = KeyHash(key);
+        bool result = false;
+        {
+            std::lock_guard<std::mutex> lock(Stripe(hash));
+            Concurrency::Epoch::Guard guard;
+
+            std::atomic<node *> *link = &Bucket(hash);
+            for (node *n = link->load(std::memory_order_relaxed); n != nullptr;
+                 link = &n->next, n = link->load(std::memory_order_relaxed)) {
+                if (n->hash == hash && n->key == key) {
+                    if (erase(n->value)) {
+                        Unlink(link, n);
+                        result = true;
+                    }
+                    break;
+                }
+            }
+        }
+
+        Migrate();
+        return result;
+    }
+
+    /**
+     * Moves CLOCK hand over buckets until some node gets removed. For each node under the hand victim(key, value,
+     * referenced) is called, node is removed if it returns true, otherwise node reference bit gets cleared.
+     * Returns false only if map is empty
+     */
+    template <typename F> bool Evict(F victim) {
+        while (_count.load(std::memory_order_relaxed) != 0) {
+            std::size_t hand = _hand.fetch_add(1, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(_stripes[hand & (kStripes - 1)]);
+            Concurrency::Epoch::Guard guard;
+
+            // Same hand value selects the bucket in the new table if the old one is moved
+            table *t = _table.load(std::memory_order_acquire);
+            while (t->buckets[hand & t->mask].load(std::memory_order_relaxed) == Moved()) {
+                t = t->next.load(std::memory_order_acquire);
+            }
+
+            std::atomic<node *> *link = &t->buckets[hand & t->mask];
+            for (node *n = link->load(std::memory_order_relaxed); n != nullptr;
+                 link = &n->next, n = link->load(std::memory_order_relaxed)) {
+                if (victim(n->key, n->value, n->referenced.load(std::memory_order_relaxed))) {
+                    Unlink(link, n);
+                    return true;
+                }
+                n->referenced.store(false, std::memory_order_relaxed);
+            }
+        }
+        return false;
+    }
+
+    // Number of keys
+    std::size_t Size() const { return _count.load(std::memory_order_relaxed); }
+
+    // Number of buckets in the newest table
+    std::size_t Buckets() const {
+        Concurrency::Epoch::Guard guard;
+        table *t = _table.load(std::memory_order_acquire);
+        table *next;
+        while ((next = t->next.load(std::memory_order_acquire)) != nullptr) {
+            t = next;
+        }
+        return t->mask + 1;
+    }
+
+private:
+    // Number of writer locks, must be a power of two not greater than initial table size
+    static constexpr std::size_t kStripes = 256;
+
+    // Table grows once there are more keys than buckets
+    static constexpr std::size_t kMaxLoad = 1;
+
+    // Number of buckets each write moves to the new table
+    static constexpr std::size_t kMigrateStep = 4;
+
+    struct node {
+        node(const std::string &k, std::size_t h, V v, node *n)
+            : key(k), hash(h), value(std::move(v)), next(n), referenced(false) {}
+
+        const std::string key;
+        const std::size_t hash;
+        const V value;
+        std::atomic<node *> next;
+        std::atomic<bool> referenced;
+    };
+
+    struct table {
+        explicit table(std::size_t size)
+            : mask(size - 1), buckets(new std::atomic<node *>[size]), next(nullptr), claimed(0), moved(0) {
+            for (std::size_t b = 0; b < size; b++) {
+                buckets[b].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<node *>[]> buckets;
+
+        // Table buckets are being moved to, nullptr if there is no resize in progress
+        std::atomic<table *> next;
+
+        // Next bucket to be moved and number of buckets moved already
+        std::atomic<std::size_t> claimed;
+        std::atomic<std::size_t> moved;
+    };
+
+    // Forwarding marker of the moved bucket
+    static node *Moved() { return reinterpret_cast<node *>(uintptr_t(1)); }
+
+    std::mutex &Stripe(std::size_t hash) { return _stripes[hash & (kStripes - 1)]; }
+
+    // Bucket the key with given hash lives in, stripe lock must be held
+    std::atomic<node *> &Bucket(std::size_t hash) {
+        table *t = _table.load(std::memory_order_acquire);
+        while (t->buckets[hash & t->mask].load(std::memory_order_relaxed) == Moved()) {
+            t = t->next.load(std::memory_order_acquire);
+        }
+        return t->buckets[hash & t->mask];
+    }
+
+    // Removes node the link points to, stripe lock must be held
+    void Unlink(std::atomic<node *> *link, node *n) {
+        link->store(n->next.load(std::memory_order_relaxed), std::memory_order_release);
+        _count.fetch_sub(1, std::memory_order_relaxed);
+        Concurrency::Epoch::Retire(n);
+    }
+
+    // Starts resize if table is overloaded and there is no resize in progress
+    void Grow() {
+        table *t = _table.load(std::memory_order_acquire);
+        if (_count.load(std::memory_order_relaxed) <= (t->mask + 1) * kMaxLoad ||
+            t->next.load(std::memory_order_acquire) != nullptr) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_resize);
+        if (_table.load(std::memory_order_acquire) == t && t->next.load(std::memory_order_relaxed) == nullptr) {
+            t->next.store(new table((t->mask + 1) * 2), std::memory_order_release);
+        }
+    }
+
+    // Moves next few buckets of the old table to the new one if there is resize in progress
+    void Migrate() {
+        Concurrency::Epoch::Guard guard;
+        table *t = _table.load(std::memory_order_acquire);
+        table *to = t->next.load(std::memory_order_acquire);
+        if (to == nullptr) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < kMigrateStep; i++) {
+            std::size_t b = t->claimed.fetch_add(1, std::memory_order_relaxed);
+            if (b > t->mask) {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_stripes[b & (kStripes - 1)]);
+                MoveBucket(t, to, b);
+            }
+
+            // Whoever moves the last bucket retires the old table
+            if (t->moved.fetch_add(1, std::memory_order_acq_rel) == t->mask) {
+                _table.store(to, std::memory_order_release);
+                Concurrency::Epoch::Retire(t);
+            }
+        }
+    }
+
+    // Copies nodes of the old bucket into two buckets of the new table, then marks old bucket as moved. Nodes are
+    // copied, not relinked, because readers could be traversing the old chain
+    void MoveBucket(table *from, table *to, std::size_t b) {
+        node *lo = nullptr, *hi = nullptr;
+        node *n = from->buckets[b].load(std::memory_order_relaxed);
+        while (n != nullptr) {
+            node *&head = (n->hash & (from->mask + 1)) ? hi : lo;
+            head = new node(n->key, n->hash, n->value, head);
+            head->referenced.store(n->referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+            node *next = n->next.load(std::memory_order_relaxed);
+            Concurrency::Epoch::Retire(n);
+            n = next;
+        }
+
+        to->buckets[b].store(lo, std::memory_order_release);
+        to->buckets[b + from->mask + 1].store(hi, std::memory_order_release);
+        from->buckets[b].store(Moved(), std::memory_order_release);
+    }
+
+    // Oldest table, it is being moved to the next one if resize is in progress
+    std::atomic<table *> _table;
+
+    std::atomic<std::size_t> _count;
+
+    // CLOCK hand for eviction
+    std::atomic<std::size_t> _hand;
+
+    std::mutex _stripes[kStripes];
+    std::mutex _resize;
+};
+
+template <typename V> constexpr std::size_t ConcurrentHashMap<V>::kStripes;
+template <typename V> constexpr std::size_t ConcurrentHashMap<V>::kMaxLoad;
+template <typename V> constexpr std::size_t ConcurrentHashMap<V>::kMigrateStep;
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CONCURRENT_HASH_MAP_H
@@ -0,0 +1,176 @@
+#ifndef AFINA_STORAGE_EXPIRY_WHEEL_H
+#define AFINA_STORAGE_EXPIRY_WHEEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Hierarchical timing wheel
+ * Index of items by their expiration time with 1 second resolution. There are 4 levels of 64 slots each, slot
+ * of level L covers 64^L seconds, so items expiring soon live in the fine grained level and items far in the
+ * future in the coarse ones. Once wheel time reaches the beginning of the coarse slot its items are moved down
+ * to the finer levels. Adding or removing an item is O(1), advancing the wheel touches only items which are
+ * either expired or get closer to the expiration, so the work could be done in slices of limited size.
+ *
+ * Index is intrusive, no memory is allocated per item. Item type must provide:
+ * - uint32_t expire: expiration time in seconds
+ * - uint16_t wheel_slot: list the item belongs to, must be initialized by kNone
+ * - T *wheel_prev, *wheel_next: list links
+ *
+ * That is NOT thread safe implementation!!
+ */
+template <typename T> class ExpiryWheel {
+public:
+    // Value of T::wheel_slot for item which isn't in the wheel
+    static constexpr uint16_t kNone = UINT16_MAX;
+
+    explicit ExpiryWheel(uint32_t now) : _now(now), _size(0), _lists(kExpired + 1, nullptr) {}
+
+    /**
+     * Adds item into the index. Item expiring not later than the current wheel time expires on the next advance
+     */
+    void Add(T *item) {
+        uint32_t delta = item->expire > _now ? item->expire - _now : 0;
+
+        uint16_t slot;
+        if (delta == 0) {
+            slot = kExpired;
+        } else {
+            std::size_t level = 0;
+            while (level + 1 < kLevels && delta >= (uint32_t(1) << (kLevelBits * (level + 1)))) {
+                level++;
+            }
+
+            // Items beyond the top level range wait in its farthest slot and get rescheduled from there
+            uint32_t at = item->expire;
+            if (level == kLevels - 1 && delta >= kTopRange) {
+                at = _now + kTopRange - 1;
+            }
+            slot = level * kSlots + ((at >> (kLevelBits * level)) & (kSlots - 1));
+        }
+
+        Link(item, slot);
+        _size++;
+    }
+
+    /**
+     * Removes item from the index, does nothing if item isn't there
+     */
+    void Remove(T *item) {
+        if (item->wheel_slot != kNone) {
+            Unlink(item);
+            _size--;
+        }
+    }
+
+    /**
+     * Moves wheel time up to now and gives expired items out to the callback, each item is removed from the index
+     * before it is passed. Each expired or cascaded item and each second the wheel time moves forward costs one
+     * unit of budget, so even after a long idle gap a call does at most budget steps, the rest are handled by the
+     * next call. Returns number of steps done, 0 means wheel caught up with now
+     */
+    template <typename F> std::size_t Advance(uint32_t now, std::size_t budget, F expire) {
+        std::size_t done = 0;
+        while (done < budget) {
+            T *item;
+            if ((item = _lists[kExpired]) != nullptr || (item = _lists[_now & (kSlots - 1)]) != nullptr) {
+                Unlink(item);
+                _size--;
+                expire(item);
+            } else if (!_cascade.empty()) {
+                // Items of the coarse slot are spread over finer levels
+                if ((item = _lists[_cascade.back()]) == nullptr) {
+                    _cascade.pop_back();
+                    continue;
+                }
+                Unlink(item);
+                _size--;
+                Add(item);
+            } else if (_now < now && _size != 0) {
+                Tick();
+            } else {
+                // Empty wheel jumps forward at once, time never goes back
+                _now = std::max(_now, now);
+                break;
+            }
+            done++;
+        }
+        return done;
+    }
+
+    // Number of items in the index
+    std::size_t Size() const { return _size; }
+
+private:
+    static constexpr std::size_t kLevels = 4;
+    static constexpr std::size_t kLevelBits = 6;
+    static constexpr std::size_t kSlots = 1 << kLevelBits;
+    static constexpr uint32_t kTopRange = uint32_t(1) << (kLevelBits * kLevels);
+
+    // Special list of items which are expired already when added
+    static constexpr uint16_t kExpired = kLevels * kSlots;
+
+    // Moves wheel time one second forward, level 0 slot of the new time becomes expired and coarse slots starting
+    // at that time have to be cascaded
+    void Tick() {
+        _now++;
+        for (std::size_t level = 1; level < kLevels; level++) {
+            if ((_now & ((uint32_t(1) << (kLevelBits * level)) - 1)) != 0) {
+                break;
+            }
+            _cascade.push_back(level * kSlots + ((_now >> (kLevelBits * level)) & (kSlots - 1)));
+        }
+    }
+
+    void Link(T *item, uint16_t slot) {
+        item->wheel_slot = slot;
+        item->wheel_prev = nullptr;
+        item->wheel_next = _lists[slot];
+        if (_lists[slot] != nullptr) {
+            _lists[slot]->wheel_prev = item;
+        }
+        _lists[slot] = item;
+    }
+
+    void Unlink(T *item) {
+        if (item->wheel_prev != nullptr) {
+            item->wheel_prev->wheel_next = item->wheel_next;
+        } else {
+            _lists[item->wheel_slot] = item->wheel_next;
+        }
+        if (item->wheel_next != nullptr) {
+            item->wheel_next->wheel_prev = item->wheel_prev;
+        }
+        item->wheel_slot = kNone;
+        item->wheel_prev = item->wheel_next = nullptr;
+    }
+
+    // Wheel time, all items expiring not later than that are either in the expired list, in the level 0 slot of
+    // that time or in the slots to be cascaded
+    uint32_t _now;
+
+    std::size_t _size;
+
+    // Heads of slots lists, level by level, followed by expired list
+    std::vector<T *> _lists;
+
+    // Coarse slots reached by the wheel time, which items are not moved to finer levels yet
+    std::vector<uint16_t> _cascade;
+};
+
+template <typename T> constexpr uint16_t ExpiryWheel<T>::kNone;
+template <typename T> constexpr std::size_t ExpiryWheel<T>::kLevels;
+template <typename T> constexpr std::size_t ExpiryWheel<T>::kLevelBits;
+template <typename T> constexpr std::size_t ExpiryWheel<T>::kSlots;
+template <typename T> constexpr uint32_t ExpiryWheel<T>::kTopRange;
+template <typename T> constexpr uint16_t ExpiryWheel<T>::kExpired;
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_EXPIRY_WHEEL_H
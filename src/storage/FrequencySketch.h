@@ -0,0 +1,94 @@
+#ifndef AFINA_STORAGE_FREQUENCY_SKETCH_H
+#define AFINA_STORAGE_FREQUENCY_SKETCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Count-min sketch of keys access frequency
+ * Each key is counted in 4 saturating counters, one per row, estimation is the minimum of them. Increment uses
+ * conservative update: only counters equal to the current estimation grow, that keeps collisions from
+ * inflating estimations of rare keys. To let sketch forget old history all counters are halved once number
+ * of increments reaches sample size
+ */
+class FrequencySketch {
+public:
+    FrequencySketch(std::size_t width) : _additions(0) {
+        std::size_t size = 64;
+        while (size < width) {
+            size *= 2;
+        }
+        _mask = size - 1;
+        _sample_size = 10 * size;
+        _counters.assign(kDepth * size, 0);
+    }
+
+    /**
+     * Counts one more access to the key with the given hash
+     */
+    void Increment(std::size_t hash) {
+        uint8_t estimation = Estimate(hash);
+        if (estimation == kMaxCount) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < kDepth; i++) {
+            uint8_t &counter = _counters[Position(hash, i)];
+            if (counter == estimation) {
+                counter++;
+            }
+        }
+
+        if (++_additions >= _sample_size) {
+            Age();
+        }
+    }
+
+    /**
+     * Returns estimated number of accesses to the key with the given hash
+     */
+    uint8_t Estimate(std::size_t hash) const {
+        uint8_t result = kMaxCount;
+        for (std::size_t i = 0; i < kDepth; i++) {
+            result = std::min(result, _counters[Position(hash, i)]);
+        }
+        return result;
+    }
+
+private:
+    static constexpr std::size_t kDepth = 4;
+    static constexpr uint8_t kMaxCount = 15;
+
+    // Counter for the key in the given row, rows use independent hashes derived from the key hash by
+    // murmur3 finalizer, so keys collided in one row most likely don't collide in others
+    std::size_t Position(std::size_t hash, std::size_t row) const {
+        uint64_t h = uint64_t(hash) + (row + 1) * 0x9E3779B97F4A7C15ULL;
+        h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCDULL;
+        h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return row * (_mask + 1) + (h & _mask);
+    }
+
+    // Halves all counters
+    void Age() {
+        for (uint8_t &counter : _counters) {
+            counter >>= 1;
+        }
+        _additions /= 2;
+    }
+
+    std::size_t _mask;
+    std::size_t _additions;
+    std::size_t _sample_size;
+    std::vector<uint8_t> _counters;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FREQUENCY_SKETCH_H
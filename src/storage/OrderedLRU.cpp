@@ -0,0 +1,191 @@
+#include "OrderedLRU.h"
+
+#include <memory>
+
+namespace Afina {
+namespace Backend {
+
+OrderedLRU::~OrderedLRU() {
+    _index.Clear();
+    while (_lru_head != nullptr) {
+        lru_node *next = _lru_head->next;
+        delete _lru_head;
+        _lru_head = next;
+    }
+}
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::Put(const std::string &key, const std::string &value) { return OrderedLRU::Put(key, value, 0); }
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::Put(const std::string &key, const std::string &value, uint32_t expire) {
+    std::size_t node_size = key.size() + value.size();
+    if (key.empty() || node_size > _max_size) {
+        return false;
+    }
+
+    lru_node *node = _index.Find(key);
+    if (node != nullptr) {
+        _size = _size - node->value->size() + value.size();
+        node->value = std::make_shared<const std::string>(value);
+        node->expire = expire;
+        Promote(node);
+
+        // Node is the tail now and it fits into the cache, so it never gets evicted here
+        while (_size > _max_size) {
+            Remove(_lru_head);
+        }
+        return true;
+    }
+
+    while (_size + node_size > _max_size) {
+        Remove(_lru_head);
+    }
+
+    node = new lru_node{key, std::make_shared<const std::string>(value), nullptr, nullptr, expire};
+    LinkTail(node);
+    _index.Insert(node);
+    _size += node_size;
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return OrderedLRU::PutIfAbsent(key, value, 0);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) {
+    if (Alive(key) != nullptr) {
+        return false;
+    }
+    return OrderedLRU::Put(key, value, expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::Set(const std::string &key, const std::string &value) {
+    lru_node *node = Alive(key);
+    if (node == nullptr) {
+        return false;
+    }
+    return OrderedLRU::Put(key, value, node->expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::Set(const std::string &key, const std::string &value, uint32_t expire) {
+    if (Alive(key) == nullptr) {
+        return false;
+    }
+    return OrderedLRU::Put(key, value, expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::Delete(const std::string &key) {
+    lru_node *node = _index.Find(key);
+    if (node == nullptr) {
+        return false;
+    }
+
+    // Expired node is removed anyway, but for the caller it was already absent
+    bool expired = Expired(*node, Now());
+    Remove(node);
+    return !expired;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::Get(const std::string &key, std::string &value) {
+    lru_node *node = Alive(key);
+    if (node == nullptr) {
+        return false;
+    }
+    value = *node->value;
+    Promote(node);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool OrderedLRU::Get(const std::string &key, Value &value) {
+    lru_node *node = Alive(key);
+    if (node == nullptr) {
+        return false;
+    }
+    value = node->value;
+    Promote(node);
+    return true;
+}
+
+// See Storage.h
+bool OrderedLRU::Scan(const std::string &prefix,
+                      const std::function<bool(const std::string &key, const Value &value)> &visit) {
+    // Scan doesn't count as use, so nodes keep their freshness
+    uint32_t now = Now();
+    _index.Scan(prefix, [&visit, now](lru_node *node) { return Expired(*node, now) || visit(node->key, node->value); });
+    return true;
+}
+
+// See Storage.h
+void OrderedLRU::Stats(std::map<std::string, std::string> &stats) {
+    stats["ordered_items"] = std::to_string(_index.Size());
+    stats["ordered_items_bytes"] = std::to_string(_size);
+    stats["ordered_limit_bytes"] = std::to_string(_max_size);
+    stats["ordered_index_bytes"] = std::to_string(_index.Bytes());
+}
+
+// See OrderedLRU.h
+OrderedLRU::lru_node *OrderedLRU::Alive(const std::string &key) {
+    lru_node *node = _index.Find(key);
+    if (node == nullptr) {
+        return nullptr;
+    }
+    if (Expired(*node, Now())) {
+        Remove(node);
+        return nullptr;
+    }
+    return node;
+}
+
+// See OrderedLRU.h
+void OrderedLRU::Remove(lru_node *node) {
+    _index.Erase(node->key);
+    Unlink(node);
+    _size -= node->key.size() + node->value->size();
+    delete node;
+}
+
+// See OrderedLRU.h
+void OrderedLRU::Promote(lru_node *node) {
+    if (node != _lru_tail) {
+        Unlink(node);
+        LinkTail(node);
+    }
+}
+
+// See OrderedLRU.h
+void OrderedLRU::Unlink(lru_node *node) {
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        _lru_head = node->next;
+    }
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    } else {
+        _lru_tail = node->prev;
+    }
+    node->prev = node->next = nullptr;
+}
+
+// See OrderedLRU.h
+void OrderedLRU::LinkTail(lru_node *node) {
+    node->prev = _lru_tail;
+    node->next = nullptr;
+    if (_lru_tail != nullptr) {
+        _lru_tail->next = node;
+    } else {
+        _lru_head = node;
+    }
+    _lru_tail = node;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,113 @@
+#ifndef AFINA_STORAGE_ORDERED_LRU_H
+#define AFINA_STORAGE_ORDERED_LRU_H
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "ArtIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU indexed by the radix tree
+ * Same eviction as SimpleLRU, but nodes are indexed by ArtIndex instead of hash table: lookup walks the key bytes,
+ * keys sharing prefixes share tree path and associations could be scanned by key prefix in order.
+ *
+ * Expired nodes are invisible right away and get removed once touched or once they reach LRU head.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class OrderedLRU : public Afina::Storage {
+public:
+    OrderedLRU(size_t max_size = 1024) : _max_size(max_size), _size(0), _lru_head(nullptr), _lru_tail(nullptr) {}
+    ~OrderedLRU();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, Value &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Scan(const std::string &prefix,
+              const std::function<bool(const std::string &key, const Value &value)> &visit) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    // LRU cache node, list is intrusive and doesn't own nodes
+    struct lru_node {
+        const std::string key;
+        Value value;
+        lru_node *prev;
+        lru_node *next;
+
+        // Expiration time in seconds since epoch, 0 if node never expires
+        uint32_t expire;
+    };
+
+    // Allows index to reach node key
+    struct lru_index_traits {
+        const std::string &Key(const lru_node *node) const { return node->key; }
+    };
+
+    static uint32_t Now() { return std::time(nullptr); }
+
+    static bool Expired(const lru_node &node, uint32_t now) { return node.expire != 0 && node.expire <= now; }
+
+    // Node for the given key or nullptr if there is no such key or it is expired. Expired node gets removed
+    lru_node *Alive(const std::string &key);
+
+    // Removes node from the list and index and releases it
+    void Remove(lru_node *node);
+
+    // Moves node into the tail of the list, so it becomes the most fresh one
+    void Promote(lru_node *node);
+
+    void Unlink(lru_node *node);
+    void LinkTail(lru_node *node);
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be not greater than the _max_size
+    std::size_t _max_size;
+    std::size_t _size;
+
+    // Nodes ordered by freshness, the head one wasn't used for the longest time
+    lru_node *_lru_head;
+    lru_node *_lru_tail;
+
+    // Index of nodes by key, owns nothing
+    ArtIndex<lru_node, lru_index_traits> _index;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_ORDERED_LRU_H
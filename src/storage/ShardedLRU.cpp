@@ -0,0 +1,173 @@
+#include "ShardedLRU.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+constexpr size_t ShardedLRU::kMinShardSize;
+
+ShardedLRU::ShardedLRU(size_t max_size, size_t shards) {
+    if (shards == 0) {
+        throw std::invalid_argument("Number of shards must be positive");
+    }
+    if (max_size / shards < kMinShardSize) {
+        throw std::invalid_argument("Memory budget is too small for " + std::to_string(shards) +
+                                    " shards, each one needs " + std::to_string(kMinShardSize) + " bytes at least");
+    }
+
+    _shards.reserve(shards);
+    for (size_t i = 0; i < shards; i++) {
+        _shards.emplace_back(new ThreadSafeSimplLRU(max_size / shards));
+    }
+}
+
+// See ShardedLRU.h
+void ShardedLRU::Start() {
+    for (auto &shard : _shards) {
+        shard->Start();
+    }
+}
+
+// See ShardedLRU.h
+void ShardedLRU::Stop() {
+    for (auto &shard : _shards) {
+        shard->Stop();
+    }
+}
+
+// See ShardedLRU.h
+void ShardedLRU::Stats(std::map<std::string, std::string> &stats) {
+    std::map<std::string, uint64_t> total;
+    for (auto &shard : _shards) {
+        std::map<std::string, std::string> part;
+        shard->Stats(part);
+        for (auto &stat : part) {
+            total[stat.first] += std::stoull(stat.second);
+        }
+    }
+
+    for (auto &stat : total) {
+        stats[stat.first] = std::to_string(stat.second);
+    }
+    stats["sharded_shards"] = std::to_string(_shards.size());
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::Put(const std::string &key, const std::string &value) { return Shard(key).Put(key, value); }
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return Shard(key).PutIfAbsent(key, value);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::Set(const std::string &key, const std::string &value) { return Shard(key).Set(key, value); }
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::Delete(const std::string &key) { return Shard(key).Delete(key); }
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::Get(const std::string &key, std::string &value) { return Shard(key).Get(key, value); }
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::Get(const std::string &key, Value &value) { return Shard(key).Get(key, value); }
+
+// See MapBasedGlobalLockImpl.h
+std::size_t ShardedLRU::MultiGet(const std::string *keys, std::size_t count, Value *values) {
+    std::vector<Key> refs;
+    refs.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        refs.emplace_back(keys[i]);
+    }
+    return ShardedLRU::MultiGet(refs.data(), count, values);
+}
+
+// See Storage.h
+bool ShardedLRU::Get(const Key &key, Value &value) { return Shard(key).Get(key, value); }
+
+// See Storage.h
+std::size_t ShardedLRU::MultiGet(const Key *keys, std::size_t count, Value *values) {
+    // Keys are grouped by shard with counting sort, so each shard lock is taken once per batch
+    std::vector<std::size_t> shard(count);
+    std::vector<std::size_t> begin(_shards.size() + 1, 0);
+    for (std::size_t i = 0; i < count; i++) {
+        shard[i] = ShardOf(keys[i].hash);
+        begin[shard[i] + 1]++;
+    }
+    for (std::size_t s = 0; s < _shards.size(); s++) {
+        begin[s + 1] += begin[s];
+    }
+
+    std::vector<uint32_t> order(count);
+    std::vector<std::size_t> next(begin.begin(), begin.end() - 1);
+    for (std::size_t i = 0; i < count; i++) {
+        order[next[shard[i]]++] = i;
+    }
+
+    std::size_t result = 0;
+    for (std::size_t s = 0; s < _shards.size(); s++) {
+        if (begin[s] != begin[s + 1]) {
+            result += _shards[s]->MultiGet(keys, order.data() + begin[s], begin[s + 1] - begin[s], values);
+        }
+    }
+    return result;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::Put(const std::string &key, const std::string &value, uint32_t expire) {
+    return Shard(key).Put(key, value, expire);
+}
+
+// See Storage.h
+bool ShardedLRU::Put(const Key &key, const std::string &value, uint32_t expire) {
+    return Shard(key).Put(key, value, expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) {
+    return Shard(key).PutIfAbsent(key, value, expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool ShardedLRU::Set(const std::string &key, const std::string &value, uint32_t expire) {
+    return Shard(key).Set(key, value, expire);
+}
+
+// See Storage.h
+bool ShardedLRU::Update(const std::string &key,
+                        const std::function<bool(const std::string &value, std::string &result)> &update) {
+    return Shard(key).Update(key, update);
+}
+
+// See Storage.h
+bool ShardedLRU::Append(const std::string &key, const std::string &data, uint64_t &version) {
+    return Shard(key).Append(key, data, version);
+}
+
+// See Storage.h
+bool ShardedLRU::Prepend(const std::string &key, const std::string &data, uint64_t &version) {
+    return Shard(key).Prepend(key, data, version);
+}
+
+// See Storage.h
+bool ShardedLRU::GetAndTouch(const std::string &key, uint32_t expire, Value &value) {
+    return Shard(key).GetAndTouch(key, expire, value);
+}
+
+// See Storage.h
+bool ShardedLRU::GetVersion(const std::string &key, Value &value, uint64_t &version) {
+    return Shard(key).GetVersion(key, value, version);
+}
+
+// See Storage.h
+bool ShardedLRU::CompareAndSet(const std::string &key, const std::string &value, uint32_t expire,
+                               uint64_t &version) {
+    return Shard(key).CompareAndSet(key, value, expire, version);
+}
+
+} // namespace Backend
+} // namespace Afina
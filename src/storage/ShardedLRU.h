@@ -0,0 +1,122 @@
+#ifndef AFINA_STORAGE_SHARDED_LRU_H
+#define AFINA_STORAGE_SHARDED_LRU_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "SwissIndex.h"
+#include "ThreadSafeSimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Lock striped LRU
+ * Key space is partitioned by key hash into a number of independent shards, each one is a thread safe LRU with
+ * its own lock and its own part of the memory budget. Threads working on different shards never contend.
+ *
+ * Note that eviction is local to the shard, so the cache as a whole is only approximately LRU. Item can't be
+ * bigger than its shard, so budget is never split into shards smaller than kMinShardSize
+ */
+class ShardedLRU : public Afina::Storage {
+public:
+    // Smallest part of the budget a shard could get
+    static constexpr size_t kMinShardSize = 256;
+
+    // Budget goes first as for every other storage, it is split between shards evenly
+    ShardedLRU(size_t max_size = 1024, size_t shards = 4);
+    ~ShardedLRU() {}
+
+    // Implements Afina::Storage interface, starts background eviction of every shard
+    void Start() override;
+
+    // Implements Afina::Storage interface
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, Value &value) override;
+
+    // Implements Afina::Storage interface
+    std::size_t MultiGet(const std::string *keys, std::size_t count, Value *values) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const Key &key, Value &value) override;
+
+    // Implements Afina::Storage interface
+    std::size_t MultiGet(const Key *keys, std::size_t count, Value *values) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const Key &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) override;
+
+    // Implements Afina::Storage interface
+    bool Versioned() const override { return true; }
+
+    // Implements Afina::Storage interface
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) override;
+
+    // Implements Afina::Storage interface, counters of all shards are summed up
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    // Shard responsible for the given key
+    ThreadSafeSimplLRU &Shard(const std::string &key) { return *_shards[ShardOf(KeyHash(key))]; }
+    ThreadSafeSimplLRU &Shard(const Key &key) { return *_shards[ShardOf(key.hash)]; }
+
+    // Number of the shard responsible for the key with the given hash
+    std::size_t ShardOf(std::size_t hash) const {
+        // Shard is selected by high bits of the hash, index inside of the shard uses the low ones
+        return ((uint64_t(hash) >> 32) * _shards.size()) >> 32;
+    }
+
+    std::vector<std::unique_ptr<ThreadSafeSimplLRU>> _shards;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SHARDED_LRU_H
@@ -0,0 +1,211 @@
+#include "SimpleClock.h"
+
+#include <algorithm>
+
+namespace Afina {
+namespace Backend {
+
+SimpleClock::SimpleClock(size_t max_size)
+    : _max_size(max_size), _size(0), _hand(0), _index(clock_index_traits{&_entries}), _last_version(0) {}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleClock::Put(const std::string &key, const std::string &value) {
+    if (key.empty()) {
+        return false;
+    }
+
+    std::size_t hash = KeyHash(key);
+    uint32_t *pos = _index.Find(key, hash);
+    if (pos == nullptr) {
+        return Insert(key, value, hash);
+    }
+
+    // Entry must survive eviction in favor of its own new value, so it gets removed and inserted again
+    // in case if the cache has to make a room for it
+    clock_entry &entry = _entries[*pos];
+    if (_size - entry.value.size() + value.size() > _max_size) {
+        Remove(*pos);
+        return Insert(key, value, hash);
+    }
+
+    _size = _size - entry.value.size() + value.size();
+    entry.value = value;
+    entry.version = ++_last_version;
+    _referenced[*pos].store(1, std::memory_order_relaxed);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleClock::PutIfAbsent(const std::string &key, const std::string &value) {
+    std::size_t hash = KeyHash(key);
+    if (key.empty() || _index.Find(key, hash) != nullptr) {
+        return false;
+    }
+    return Insert(key, value, hash);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleClock::Set(const std::string &key, const std::string &value) {
+    if (_index.Find(key, KeyHash(key)) == nullptr) {
+        return false;
+    }
+    return SimpleClock::Put(key, value);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleClock::Delete(const std::string &key) {
+    uint32_t *pos = _index.Find(key, KeyHash(key));
+    if (pos == nullptr) {
+        return false;
+    }
+    Remove(*pos);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleClock::Get(const std::string &key, std::string &value) {
+    uint32_t *pos = _index.Find(key, KeyHash(key));
+    if (pos == nullptr) {
+        return false;
+    }
+    value = _entries[*pos].value;
+    _referenced[*pos].store(1, std::memory_order_relaxed);
+    return true;
+}
+
+// See SimpleClock.h
+bool SimpleClock::Update(const std::string &key,
+                         const std::function<bool(const std::string &value, std::string &result)> &update) {
+    std::string value, result;
+    if (!SimpleClock::Get(key, value) || !update(value, result)) {
+        return false;
+    }
+    return SimpleClock::Put(key, result);
+}
+
+// See SimpleClock.h
+bool SimpleClock::Append(const std::string &key, const std::string &data, uint64_t &version) {
+    if (!SimpleClock::Update(key, Extender(data, false))) {
+        return false;
+    }
+    version = _last_version;
+    return true;
+}
+
+// See SimpleClock.h
+bool SimpleClock::Prepend(const std::string &key, const std::string &data, uint64_t &version) {
+    if (!SimpleClock::Update(key, Extender(data, true))) {
+        return false;
+    }
+    version = _last_version;
+    return true;
+}
+
+// See SimpleClock.h
+bool SimpleClock::GetAndTouch(const std::string &key, uint32_t expire, Value &value) {
+    std::string current;
+    if (!SimpleClock::Get(key, current)) {
+        return false;
+    }
+    value = std::make_shared<const std::string>(std::move(current));
+    return true;
+}
+
+// See SimpleClock.h
+bool SimpleClock::GetVersion(const std::string &key, Value &value, uint64_t &version) {
+    uint32_t *pos = _index.Find(key, KeyHash(key));
+    if (pos == nullptr) {
+        return false;
+    }
+    value = std::make_shared<const std::string>(_entries[*pos].value);
+    version = _entries[*pos].version;
+    _referenced[*pos].store(1, std::memory_order_relaxed);
+    return true;
+}
+
+// See SimpleClock.h
+bool SimpleClock::CompareAndSet(const std::string &key, const std::string &value, uint32_t expire,
+                                uint64_t &version) {
+    uint32_t *pos = _index.Find(key, KeyHash(key));
+    if (pos == nullptr || _entries[*pos].version != version) {
+        version = pos == nullptr ? 0 : _entries[*pos].version;
+        return false;
+    }
+    if (!SimpleClock::Put(key, value)) {
+        return false;
+    }
+    version = _last_version;
+    return true;
+}
+
+// See SimpleClock.h
+bool SimpleClock::Insert(const std::string &key, const std::string &value, std::size_t hash) {
+    std::size_t entry_size = key.size() + value.size();
+    if (entry_size > _max_size) {
+        return false;
+    }
+
+    while (_size + entry_size > _max_size) {
+        Evict();
+    }
+
+    uint32_t pos;
+    if (!_free.empty()) {
+        pos = _free.back();
+        _free.pop_back();
+    } else {
+        // Reference bits are atomics, so they couldn't be moved by vector and have to be copied by hands
+        pos = _entries.size();
+        if (pos == _entries.capacity()) {
+            std::size_t capacity = std::max<std::size_t>(16, 2 * _entries.capacity());
+            std::unique_ptr<std::atomic<uint8_t>[]> referenced(new std::atomic<uint8_t>[capacity]);
+            for (std::size_t i = 0; i < _entries.size(); i++) {
+                referenced[i].store(_referenced[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            _referenced = std::move(referenced);
+            _entries.reserve(capacity);
+        }
+        _entries.emplace_back();
+    }
+
+    _entries[pos].key = key;
+    _entries[pos].value = value;
+    _entries[pos].version = ++_last_version;
+    _referenced[pos].store(0, std::memory_order_relaxed);
+    _index.Insert(pos, hash);
+    _size += entry_size;
+    return true;
+}
+
+// See SimpleClock.h
+void SimpleClock::Remove(uint32_t pos) {
+    clock_entry &entry = _entries[pos];
+    _index.Erase(entry.key, KeyHash(entry.key));
+    _size -= entry.key.size() + entry.value.size();
+
+    // Release memory, not just size
+    std::string().swap(entry.key);
+    std::string().swap(entry.value);
+    _free.push_back(pos);
+}
+
+// See SimpleClock.h
+void SimpleClock::Evict() {
+    // Caller guarantees there is something to evict, so at most two rounds are needed: the first one might
+    // clear all the reference bits
+    while (true) {
+        uint32_t pos = _hand;
+        _hand = (_hand + 1) % _entries.size();
+
+        if (_entries[pos].key.empty()) {
+            continue;
+        }
+        if (_referenced[pos].exchange(0, std::memory_order_relaxed) == 0) {
+            Remove(pos);
+            return;
+        }
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
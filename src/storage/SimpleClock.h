@@ -0,0 +1,125 @@
+#ifndef AFINA_STORAGE_SIMPLE_CLOCK_H
+#define AFINA_STORAGE_SIMPLE_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+
+#include "SwissIndex.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK eviction based implementation
+ * Entries live in the dense array, each one has a reference bit. Hit only sets the bit, so it doesn't change
+ * any shared structure and could be done concurrently. To find a victim clock hand sweeps over the array:
+ * referenced entries get a second chance and their bit cleared, the first not referenced entry gets evicted.
+ *
+ * That is NOT thread safe implementaiton!! But Get could be called concurrently as long as there is no
+ * modifications running
+ */
+class SimpleClock : public Afina::Storage {
+public:
+    SimpleClock(size_t max_size = 1024);
+    ~SimpleClock() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface. Unlike the default one never calls other virtual methods, so thread safe
+    // version runs it under its own lock
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update) override;
+
+    // Implements Afina::Storage interface, same as Update never calls other virtual methods
+    bool Append(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // Implements Afina::Storage interface, same as Update never calls other virtual methods
+    bool Prepend(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // Implements Afina::Storage interface. Clock doesn't keep expiration time, so that is just Get
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) override;
+
+    // Implements Afina::Storage interface
+    bool Versioned() const override { return true; }
+
+    // Implements Afina::Storage interface
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) override;
+
+    // Implements Afina::Storage interface. Check and write don't call other virtual methods, so thread safe version
+    // makes them atomic by its own lock
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) override;
+
+private:
+    // Cache entry, free entry has an empty key
+    struct clock_entry {
+        std::string key;
+        std::string value;
+
+        // Version of the value, changes every time the value is written
+        uint64_t version;
+    };
+
+    // Allows index to reach entry key by its position
+    struct clock_index_traits {
+        const std::vector<clock_entry> *entries;
+
+        std::size_t Hash(const uint32_t &pos) const { return KeyHash((*entries)[pos].key); }
+        bool Equal(const uint32_t &pos, const std::string &key) const { return (*entries)[pos].key == key; }
+    };
+
+    // Puts new entry, key must be absent
+    bool Insert(const std::string &key, const std::string &value, std::size_t hash);
+
+    // Releases entry on the given position
+    void Remove(uint32_t pos);
+
+    // Advances clock hand until an entry is evicted
+    void Evict();
+
+    // Maximum number of bytes could be stored in this cache.
+    // i.e all (keys+values) must be not greater than the _max_size
+    std::size_t _max_size;
+    std::size_t _size;
+
+    // All entries, both used and free
+    std::vector<clock_entry> _entries;
+
+    // Reference bit for each entry, it is the only thing Get changes
+    std::unique_ptr<std::atomic<uint8_t>[]> _referenced;
+
+    // Positions of free entries
+    std::vector<uint32_t> _free;
+
+    // Clock hand, entry to be checked for eviction next
+    uint32_t _hand;
+
+    // Index of entries positions
+    SwissIndex<uint32_t, clock_index_traits> _index;
+
+    // Version given to the last written value
+    uint64_t _last_version;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SIMPLE_CLOCK_H
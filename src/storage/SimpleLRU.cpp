@@ -1,124 +1,434 @@
 #include "SimpleLRU.h"
 
+#include <vector>
+
 namespace Afina {
 namespace Backend {
 
+constexpr std::size_t SimpleLRU::kExpireSlice;
+constexpr std::size_t SimpleLRU::kPrefetchDistance;
+constexpr std::size_t SimpleLRU::kMaxChunks;
+
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Put(const std::string &key, const std::string &value) {
-    if (key.empty()) {
+bool SimpleLRU::Put(const std::string &key, const std::string &value) { return SimpleLRU::Put(key, value, 0); }
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Put(const std::string &key, const std::string &value, uint32_t expire) {
+    if (key.size() + value.size() > _max_size) {
         return false;
     }
-    auto it = _lru_index.find(key);
-    if (it == _lru_index.end()) {
-        std::unique_ptr<lru_node> newNode(new lru_node{key, value, nullptr, nullptr});
-        if (!_lru_head) {
-            _lru_head = std::move(newNode);
-            _lru_index.emplace(key, *_lru_head);
-            currSize += key.size() + value.size();
-        }
-        else if (!_lru_head->next) {
-            currSize += key.size() + value.size();
-            while (currSize > _max_size) {
-                Delete(_lru_head->key);
-            }
-            lru_node* tempNode = nullptr;
-            _lru_head->next = std::move(newNode);
-            tempNode = _lru_head->next.get();
-            tempNode->prev = _lru_head.get();
-            _lru_tail = tempNode;
-            _lru_index.emplace(key, *_lru_tail);
-        }
-        else {
-            currSize += key.size() + value.size();
-            while (currSize > _max_size) {
-                Delete(_lru_head->key);
-            }
-            _lru_tail->next = std::move(newNode);
-            lru_node* tempNode = nullptr;
-            tempNode = _lru_tail->next.get();
-            tempNode->prev = _lru_tail;
-            _lru_tail = tempNode;
-            _lru_index.emplace(key, *_lru_tail);
+    return SimpleLRU::Put(Key(key), std::make_shared<const std::string>(value), expire);
+}
+
+// See Storage.h
+bool SimpleLRU::Put(const Key &key, const std::string &value, uint32_t expire) {
+    if (key.size + value.size() > _max_size) {
+        return false;
+    }
+    return SimpleLRU::Put(key, std::make_shared<const std::string>(value), expire);
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Put(const Key &key, Value value, uint32_t expire) {
+    if (key.size == 0) {
+        return false;
+    }
+    std::size_t node_size = key.size + value->size();
+    if (node_size > _max_size) {
+        return false;
+    }
+
+    SimpleLRU::Expire(Now(), kExpireSlice);
+
+    lru_node **it = _lru_index.Find(key, key.hash);
+    if (it != nullptr) {
+        lru_node &node = **it;
+        currSize = currSize - ValueSize(node) + value->size();
+        node.value = std::move(value);
+        node.chunks.reset();
+        node.version = ++_last_version;
+        Retime(node, expire);
+        Promote(node);
+
+        // Node is the tail now and it fits into the cache, so it never gets evicted here
+        while (currSize > _max_size) {
+            SimpleLRU::Delete(_lru_head->key);
         }
         return true;
     }
-    currSize -= it->second.get().value.size() - value.size();
-    it->second.get().value = value;
+
+    while (currSize + node_size > _max_size) {
+        SimpleLRU::Delete(_lru_head->key);
+    }
+
+    std::unique_ptr<lru_node> newNode(
+        new lru_node{key.str(), std::move(value), nullptr, _lru_tail, expire, ExpiryWheel<lru_node>::kNone, nullptr, nullptr,
+                     ++_last_version, nullptr});
+    lru_node *node = newNode.get();
+    if (expire != 0) {
+        _wheel.Add(node);
+    }
+    if (_lru_tail != nullptr) {
+        _lru_tail->next = std::move(newNode);
+    } else {
+        _lru_head = std::move(newNode);
+    }
+    _lru_tail = node;
+    _lru_index.Insert(node, key.hash);
+    currSize += node_size;
     return true;
 }
 
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
-    if (_lru_index.find(key) == _lru_index.end()) {
-        Put(key, value);
-        return true;
+    return SimpleLRU::PutIfAbsent(key, value, 0);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) {
+    if (Alive(Key(key)) != nullptr) {
+        return false;
     }
-    return false;
+    return SimpleLRU::Put(key, value, expire);
 }
 
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Set(const std::string &key, const std::string &value) {
-    auto it = _lru_index.find(key);
-    if (it == _lru_index.end()) {
+    lru_node *node = Alive(Key(key));
+    if (node == nullptr) {
         return false;
     }
-    currSize -= it->second.get().value.size();
-    it->second.get().value = value;
-    currSize += value.size();
-    while (currSize >= _max_size) {
-        Delete(_lru_head->key);
+    return SimpleLRU::Put(key, value, node->expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Set(const std::string &key, const std::string &value, uint32_t expire) {
+    if (Alive(Key(key)) == nullptr) {
+        return false;
     }
-    Delete(key);
-    Put(key, value);
-    return true;
+    return SimpleLRU::Put(key, value, expire);
 }
 
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Delete(const std::string &key) {
-    auto it = _lru_index.find(key);
-    if (it == _lru_index.end()) {
+    std::size_t hash = KeyHash(key);
+    lru_node **it = _lru_index.Find(key, hash);
+    if (it == nullptr) {
         return false;
     }
-    auto currNode = it->second;
+
+    // Expired node is removed anyway, but for the caller it was already absent
+    bool expired = Expired(**it, Now());
+    _wheel.Remove(*it);
+
+    std::reference_wrapper<lru_node> currNode = **it;
     if (!currNode.get().prev && !currNode.get().next) {
         currSize = 0;
-        _lru_index.erase(key);
+        _lru_index.Erase(key, hash);
         _lru_head.reset();
         _lru_tail = nullptr;
-        return true;
+        return !expired;
     }
     else if (currNode.get().prev == nullptr) {
-        currSize -= key.size() + currNode.get().value.size();
-        _lru_index.erase(key);
+        currSize -= key.size() + ValueSize(currNode.get());
+        _lru_index.Erase(key, hash);
         currNode.get().next->prev = nullptr;
         _lru_head = std::move(currNode.get().next);
     }
     else if (currNode.get().next == nullptr) {
-        currSize -= key.size() + currNode.get().value.size();
-        _lru_index.erase(key);
+        currSize -= key.size() + ValueSize(currNode.get());
+        _lru_index.Erase(key, hash);
         _lru_tail = currNode.get().prev;
         currNode.get().prev->next.reset();
     }
     else {
-        currSize -= key.size() + currNode.get().value.size();
-        _lru_index.erase(key);
+        currSize -= key.size() + ValueSize(currNode.get());
+        _lru_index.Erase(key, hash);
         currNode.get().next->prev = currNode.get().prev;
         currNode.get().prev->next = std::move(currNode.get().next);
     }
-    return true;
+    return !expired;
 }
 
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Get(const std::string &key, std::string &value) {
-    auto it = _lru_index.find(key);
-    if (it == _lru_index.end()) {
+    lru_node *node = Alive(Key(key));
+    if (node == nullptr) {
+        return false;
+    }
+    value = *Joined(*node);
+    Promote(*node);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Get(const std::string &key, Value &value) {
+    lru_node *node = Alive(Key(key));
+    if (node == nullptr) {
+        return false;
+    }
+    value = Joined(*node);
+    Promote(*node);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+std::size_t SimpleLRU::MultiGet(const std::string *keys, std::size_t count, Value *values) {
+    std::vector<Key> refs;
+    refs.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        refs.emplace_back(keys[i]);
+    }
+    return SimpleLRU::MultiGet(refs.data(), count, values);
+}
+
+// See Storage.h
+bool SimpleLRU::Get(const Key &key, Value &value) {
+    lru_node *node = Alive(key);
+    if (node == nullptr) {
         return false;
     }
-    value = it->second.get().value;
-    Delete(key);
-    Put(key, value);
+    value = Joined(*node);
+    Promote(*node);
     return true;
 }
 
+// See Storage.h
+std::size_t SimpleLRU::MultiGet(const Key *keys, std::size_t count, Value *values) {
+    std::vector<uint32_t> order(count);
+    for (std::size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    return SimpleLRU::MultiGet(keys, order.data(), count, values);
+}
+
+// See SimpleLRU.h
+std::size_t SimpleLRU::MultiGet(const Key *keys, const uint32_t *order, std::size_t count, Value *values) {
+    for (std::size_t i = 0; i < count && i < kPrefetchDistance; i++) {
+        _lru_index.Prefetch(keys[order[i]].hash);
+    }
+
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        if (i + kPrefetchDistance < count) {
+            _lru_index.Prefetch(keys[order[i + kPrefetchDistance]].hash);
+        }
+
+        uint32_t k = order[i];
+        lru_node *node = Alive(keys[k]);
+        if (node != nullptr) {
+            values[k] = Joined(*node);
+            Promote(*node);
+            result++;
+        } else {
+            values[k].reset();
+        }
+    }
+    return result;
+}
+
+// See Storage.h
+bool SimpleLRU::Update(const std::string &key,
+                       const std::function<bool(const std::string &value, std::string &result)> &update) {
+    lru_node *node = Alive(Key(key));
+    std::string result;
+    if (node == nullptr || !update(*Joined(*node), result)) {
+        return false;
+    }
+    return SimpleLRU::Put(Key(key), std::make_shared<const std::string>(std::move(result)), node->expire);
+}
+
+// See Storage.h
+bool SimpleLRU::GetAndTouch(const std::string &key, uint32_t expire, Value &value) {
+    lru_node *node = Alive(Key(key));
+    if (node == nullptr) {
+        return false;
+    }
+    Retime(*node, expire);
+    value = Joined(*node);
+    Promote(*node);
+    return true;
+}
+
+// See Storage.h
+bool SimpleLRU::GetVersion(const std::string &key, Value &value, uint64_t &version) {
+    lru_node *node = Alive(Key(key));
+    if (node == nullptr) {
+        return false;
+    }
+    value = Joined(*node);
+    version = node->version;
+    Promote(*node);
+    return true;
+}
+
+// See Storage.h
+bool SimpleLRU::CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) {
+    lru_node *node = Alive(Key(key));
+    if (node == nullptr || node->version != version) {
+        version = node == nullptr ? 0 : node->version;
+        return false;
+    }
+    if (!SimpleLRU::Put(key, value, expire)) {
+        return false;
+    }
+    version = _last_version;
+    return true;
+}
+
+// See Storage.h
+bool SimpleLRU::Append(const std::string &key, const std::string &data, uint64_t &version) {
+    return Extend(key, data, false, version);
+}
+
+// See Storage.h
+bool SimpleLRU::Prepend(const std::string &key, const std::string &data, uint64_t &version) {
+    return Extend(key, data, true, version);
+}
+
+// See SimpleLRU.h
+std::size_t SimpleLRU::Expire(uint32_t now, std::size_t budget) {
+    return _wheel.Advance(now, budget, [this](lru_node *node) { SimpleLRU::Delete(node->key); });
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Pop(std::string &key, Value &value) {
+    if (!_lru_head) {
+        return false;
+    }
+    key = _lru_head->key;
+    value = Joined(*_lru_head);
+    SimpleLRU::Delete(key);
+    return true;
+}
+
+// See SimpleLRU.h
+std::size_t SimpleLRU::Shrink(std::size_t target, std::size_t budget) {
+    std::size_t evicted = 0;
+    while (currSize > target && evicted < budget) {
+        SimpleLRU::Delete(_lru_head->key);
+        evicted++;
+    }
+    return evicted;
+}
+
+// See SimpleLRU.h
+SimpleLRU::lru_node *SimpleLRU::Alive(const Key &key) {
+    lru_node **it = _lru_index.Find(key, key.hash);
+    if (it == nullptr) {
+        return nullptr;
+    }
+    if (Expired(**it, Now())) {
+        SimpleLRU::Delete((*it)->key);
+        return nullptr;
+    }
+    return *it;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Promote(lru_node &node) {
+    if (&node == _lru_tail) {
+        return;
+    }
+
+    // Node isn't the tail, so it has next one for sure
+    std::unique_ptr<lru_node> owner;
+    if (node.prev == nullptr) {
+        owner = std::move(_lru_head);
+        _lru_head = std::move(node.next);
+        _lru_head->prev = nullptr;
+    } else {
+        owner = std::move(node.prev->next);
+        node.prev->next = std::move(node.next);
+        node.prev->next->prev = node.prev;
+    }
+
+    node.prev = _lru_tail;
+    _lru_tail->next = std::move(owner);
+    _lru_tail = &node;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Retime(lru_node &node, uint32_t expire) {
+    if (node.expire == expire) {
+        return;
+    }
+    _wheel.Remove(&node);
+    node.expire = expire;
+    if (expire != 0) {
+        _wheel.Add(&node);
+    }
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Extend(const std::string &key, const std::string &data, bool head, uint64_t &version) {
+    SimpleLRU::Expire(Now(), kExpireSlice);
+    lru_node *node = Alive(Key(key));
+    if (node == nullptr || key.size() + ValueSize(*node) + data.size() > _max_size) {
+        return false;
+    }
+
+    if (!node->chunks) {
+        node->chunks.reset(new value_chunks{{}, {}, 0});
+    }
+
+    std::vector<std::string> &chunks = head ? node->chunks->head : node->chunks->tail;
+    chunks.push_back(data);
+    if (chunks.size() > kMaxChunks) {
+        Compact(chunks, head);
+    }
+    node->chunks->size += data.size();
+    node->version = version = ++_last_version;
+    currSize += data.size();
+    Promote(*node);
+
+    // Node is the tail now and it fits into the cache, so it never gets evicted here
+    while (currSize > _max_size) {
+        SimpleLRU::Delete(_lru_head->key);
+    }
+    return true;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::Compact(std::vector<std::string> &chunks, bool head) {
+    std::size_t merge = 0;
+    for (std::size_t i = 1; i + 1 < chunks.size(); i++) {
+        if (chunks[i].size() + chunks[i + 1].size() < chunks[merge].size() + chunks[merge + 1].size()) {
+            merge = i;
+        }
+    }
+
+    // Chunks are never merged with the value itself, so appending small pieces to the large value copies only
+    // pieces, each of them is copied about log(number of pieces) times
+    if (head) {
+        chunks[merge + 1].append(chunks[merge]);
+        chunks[merge].swap(chunks[merge + 1]);
+    } else {
+        chunks[merge].append(chunks[merge + 1]);
+    }
+    chunks.erase(chunks.begin() + merge + 1);
+}
+
+// See SimpleLRU.h
+const SimpleLRU::Value &SimpleLRU::Joined(lru_node &node) {
+    if (!node.chunks) {
+        return node.value;
+    }
+
+    std::string value;
+    value.reserve(ValueSize(node));
+    for (auto it = node.chunks->head.rbegin(); it != node.chunks->head.rend(); it++) {
+        value.append(*it);
+    }
+    value.append(*node.value);
+    for (auto &chunk : node.chunks->tail) {
+        value.append(chunk);
+    }
+
+    node.value = std::make_shared<const std::string>(std::move(value));
+    node.chunks.reset();
+    return node.value;
+}
+
 } // namespace Backend
 } // namespace Afina
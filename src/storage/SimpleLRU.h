@@ -1,27 +1,44 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
-#include <map>
+#include <cstdint>
+#include <ctime>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <afina/Storage.h>
 
+#include "ExpiryWheel.h"
+#include "SwissIndex.h"
+
 namespace Afina {
 namespace Backend {
 
 /**
  * # Map based implementation
+ * Expired nodes are invisible right away and get removed either once touched or by the wheel sweep, which is done
+ * in small slices on every write.
+ *
+ * Append and Prepend don't copy the value: data is linked to the node as a separate chunk, value and its chunks
+ * are joined only once the node is read.
+ *
  * That is NOT thread safe implementaiton!!
  */
 class SimpleLRU : public Afina::Storage {
 public:
-    SimpleLRU(size_t max_size = 1024) : _max_size(max_size), currSize(0) {}
+    SimpleLRU(size_t max_size = 1024)
+        : _max_size(max_size), currSize(0), _lru_tail(nullptr), _wheel(Now()), _last_version(0) {}
 
     ~SimpleLRU() {
-        _lru_index.clear();
-        _lru_head.reset(); // TODO: Here is stack overflow
+        _lru_index.Clear();
+
+        // Release nodes one by one, recursive unique_ptr destruction overflows stack on long lists
+        while (_lru_head) {
+            std::unique_ptr<lru_node> next = std::move(_lru_head->next);
+            _lru_head = std::move(next);
+        }
     }
 
     // Implements Afina::Storage interface
@@ -39,13 +56,160 @@ public:
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
-private:
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, Value &value) override;
+
+    // Implements Afina::Storage interface
+    std::size_t MultiGet(const std::string *keys, std::size_t count, Value *values) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const Key &key, Value &value) override;
+
+    // Implements Afina::Storage interface
+    std::size_t MultiGet(const Key *keys, std::size_t count, Value *values) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const Key &key, const std::string &value, uint32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update) override;
+
+    // Implements Afina::Storage interface
+    bool Append(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool Prepend(const std::string &key, const std::string &data, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) override;
+
+    // Implements Afina::Storage interface
+    bool Versioned() const override { return true; }
+
+    // Implements Afina::Storage interface
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) override;
+
+    // Implements Afina::Storage interface
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) override;
+
+    /**
+     * Same as MultiGet above, but processes only keys[order[i]] for i below count
+     */
+    virtual std::size_t MultiGet(const Key *keys, const uint32_t *order, std::size_t count, Value *values);
+
+    // Removes nodes expired by the given time doing at most budget steps of the wheel. Returns number of steps done
+    std::size_t Expire(uint32_t now, std::size_t budget);
+
+    // Same as Put, but takes already shared value buffer
+    bool Put(const Key &key, Value value, uint32_t expire);
+
+    // Number of bytes used by all keys and values
+    std::size_t Size() const { return currSize; }
+
+    // Checks if the key is present, doesn't change freshness of the key
+    bool Contains(const std::string &key) { return Alive(Key(key)) != nullptr; }
+
+    // Key of the least recently used node or nullptr if cache is empty
+    const std::string *Oldest() const { return _lru_head ? &_lru_head->key : nullptr; }
+
+    // Removes the least recently used node and gives its content out. Returns false if cache is empty
+    bool Pop(std::string &key, Value &value);
+
+    // Evicts least recently used nodes until size is not greater than target, at most budget of them. Returns
+    // number of nodes evicted
+    std::size_t Shrink(std::size_t target, std::size_t budget);
+
+protected:
+    // Data added by Append and Prepend but not joined with the value yet. Both lists keep chunks in the order
+    // they were added, so head one goes backwards: the last chunk is the first one in the value
+    struct value_chunks {
+        std::vector<std::string> head;
+        std::vector<std::string> tail;
+
+        // Number of bytes in all chunks
+        std::size_t size;
+    };
+
     // LRU cache node
     using lru_node = struct lru_node {
         const std::string key;
-        std::string value;
+        Value value;
         std::unique_ptr<lru_node> next;
         lru_node* prev;
+
+        // Expiration time in seconds since epoch, 0 if node never expires
+        uint32_t expire;
+
+        // Place in the expiration wheel
+        uint16_t wheel_slot;
+        lru_node *wheel_prev;
+        lru_node *wheel_next;
+
+        // Changes every time value gets replaced
+        uint64_t version;
+
+        // Chunks to be joined with the value, nullptr if there are none
+        std::unique_ptr<value_chunks> chunks;
+    };
+
+    // Chunks list longer than that gets the smallest neighbour chunks merged
+    static constexpr std::size_t kMaxChunks = 16;
+
+    // Maximum number of expired nodes removed by single write
+    static constexpr std::size_t kExpireSlice = 16;
+
+    // Current time in the expiration time units
+    static uint32_t Now() { return std::time(nullptr); }
+
+    static bool Expired(const lru_node &node, uint32_t now) { return node.expire != 0 && node.expire <= now; }
+
+    // Number of value bytes of the node including chunks not joined yet
+    static std::size_t ValueSize(const lru_node &node) {
+        return node.value->size() + (node.chunks ? node.chunks->size : 0);
+    }
+
+    // Node for the given key or nullptr, doesn't change nodes order
+    lru_node *Lookup(const Key &key) {
+        lru_node **it = _lru_index.Find(key, key.hash);
+        return it == nullptr ? nullptr : *it;
+    }
+
+    // How many keys ahead of the current one batch lookup prefetches index
+    static constexpr std::size_t kPrefetchDistance = 4;
+
+    // Node for the given key or nullptr if there is no such key or it is expired. Expired node gets removed
+    lru_node *Alive(const Key &key);
+
+    // Moves node into the tail of the list, so it becomes the most fresh one
+    void Promote(lru_node &node);
+
+    // Changes expiration time of the node, moves it in the wheel accordingly
+    void Retime(lru_node &node, uint32_t expire);
+
+    // Links data to the value of the alive node before or after it, see Append
+    bool Extend(const std::string &key, const std::string &data, bool head, uint64_t &version);
+
+    // Merges the pair of neighbour chunks having the smallest total size, head tells the list direction
+    static void Compact(std::vector<std::string> &chunks, bool head);
+
+    // Value of the node with all its chunks joined
+    const Value &Joined(lru_node &node);
+
+    // Allows index to reach node key
+    struct lru_index_traits {
+        std::size_t Hash(lru_node *const &node) const { return KeyHash(node->key); }
+        bool Equal(lru_node *const &node, const std::string &key) const { return node->key == key; }
+        bool Equal(lru_node *const &node, const Key &key) const { return key == node->key; }
     };
 
     // Maximum number of bytes could be stored in this cache.
@@ -60,8 +224,15 @@ private:
     std::unique_ptr<lru_node> _lru_head;
     lru_node* _lru_tail;
 
-    // Index of nodes from list above, allows fast random access to elements by lru_node#key
-    std::map<const std::string, std::reference_wrapper<lru_node>, std::less<std::string>> _lru_index;
+    // Index of nodes from list above, allows fast random access to elements by lru_node#key. Index refers
+    // to the key inside of node, so there is no second copy of it
+    SwissIndex<lru_node *, lru_index_traits> _lru_index;
+
+    // Index of nodes having expiration time
+    ExpiryWheel<lru_node> _wheel;
+
+    // Version given to the last written value
+    uint64_t _last_version;
 };
 
 } // namespace Backend
@@ -0,0 +1,231 @@
+#ifndef AFINA_STORAGE_SWISS_INDEX_H
+#define AFINA_STORAGE_SWISS_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <afina/Key.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Afina {
+namespace Backend {
+
+// Hash function used by all storage indexes, see Key.h
+using Afina::KeyHash;
+
+/**
+ * # Open addressing hash index
+ * SwissTable-like hash index: every slot has 1-byte control tag which is either EMPTY, DELETED or 7 low bits of
+ * the key hash. Tags are grouped by 16 and whole group is matched against the looked up hash by a single SSE2
+ * comparison, so lookup usually touches one cache line of control bytes and one slot.
+ *
+ * Index doesn't own keys, slot values are expected to be small handles (pointers, offsets) which are able to
+ * reach the key. Traits type must provide:
+ * - std::size_t Hash(const T &slot) const: hash of the key slot refers to, used on rehash
+ * - bool Equal(const T &slot, const K &key) const: true if slot refers to the given key
+ *
+ * That is NOT thread safe implementation!!
+ */
+template <typename T, typename Traits> class SwissIndex {
+public:
+    SwissIndex(Traits traits = Traits()) : _traits(traits), _size(0), _growth_left(0), _mask(0) {}
+
+    /**
+     * Returns pointer to the slot refers to the given key or nullptr if there is no such key in the index.
+     * Pointer stays valid until next Insert or Erase
+     */
+    template <typename K> T *Find(const K &key, std::size_t hash) {
+        if (_ctrl.empty()) {
+            return nullptr;
+        }
+
+        const int8_t h2 = H2(hash);
+        std::size_t group = H1(hash) & _mask;
+        for (std::size_t step = 1;; step++) {
+            const int8_t *ctrl = &_ctrl[group * kGroupWidth];
+            for (uint32_t match = Match(ctrl, h2); match != 0; match &= match - 1) {
+                std::size_t pos = group * kGroupWidth + __builtin_ctz(match);
+                if (_traits.Equal(_slots[pos], key)) {
+                    return &_slots[pos];
+                }
+            }
+
+            if (Match(ctrl, kEmpty) != 0) {
+                return nullptr;
+            }
+            group = (group + step) & _mask;
+        }
+    }
+
+    /**
+     * Adds new slot into the index. Caller must ensure that there is no slot for the same key yet
+     */
+    void Insert(const T &value, std::size_t hash) {
+        if (_growth_left == 0) {
+            Grow();
+        }
+
+        std::size_t pos = FindFree(hash);
+        if (_ctrl[pos] == kEmpty) {
+            _growth_left--;
+        }
+        _ctrl[pos] = H2(hash);
+        _slots[pos] = value;
+        _size++;
+    }
+
+    /**
+     * Removes slot refers to the given key, returns false if there was no such key
+     */
+    template <typename K> bool Erase(const K &key, std::size_t hash) {
+        T *slot = Find(key, hash);
+        if (slot == nullptr) {
+            return false;
+        }
+
+        std::size_t pos = slot - &_slots[0];
+        const int8_t *ctrl = &_ctrl[pos & ~(kGroupWidth - 1)];
+
+        // Probe sequence never goes through the group that has empty slot, so if there is one already then
+        // nobody could be placed behind this group and slot could be freed completely
+        if (Match(ctrl, kEmpty) != 0) {
+            _ctrl[pos] = kEmpty;
+            _growth_left++;
+        } else {
+            _ctrl[pos] = kDeleted;
+        }
+        _size--;
+        return true;
+    }
+
+    /**
+     * Hints CPU to bring group of control bytes for the given hash and its slots into cache
+     */
+    void Prefetch(std::size_t hash) const {
+        if (!_ctrl.empty()) {
+            std::size_t pos = (H1(hash) & _mask) * kGroupWidth;
+            __builtin_prefetch(&_ctrl[pos]);
+            __builtin_prefetch(&_slots[pos]);
+        }
+    }
+
+    void Clear() {
+        _ctrl.clear();
+        _slots.clear();
+        _size = 0;
+        _growth_left = 0;
+        _mask = 0;
+    }
+
+    std::size_t Size() const { return _size; }
+
+    std::size_t Capacity() const { return _slots.size(); }
+
+private:
+    static constexpr std::size_t kGroupWidth = 16;
+    static constexpr int8_t kEmpty = -128;
+    static constexpr int8_t kDeleted = -2;
+
+    static std::size_t H1(std::size_t hash) { return hash >> 7; }
+    static int8_t H2(std::size_t hash) { return hash & 0x7F; }
+
+    // Bit mask of slots in the group which control byte is equal to the given tag
+    static uint32_t Match(const int8_t *ctrl, int8_t tag) {
+#if defined(__SSE2__)
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), group));
+#else
+        uint32_t result = 0;
+        for (std::size_t i = 0; i < kGroupWidth; i++) {
+            result |= uint32_t(ctrl[i] == tag) << i;
+        }
+        return result;
+#endif
+    }
+
+    // Bit mask of slots in the group which are either empty or deleted
+    static uint32_t MatchFree(const int8_t *ctrl) {
+#if defined(__SSE2__)
+        return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl)));
+#else
+        uint32_t result = 0;
+        for (std::size_t i = 0; i < kGroupWidth; i++) {
+            result |= uint32_t(ctrl[i] < 0) << i;
+        }
+        return result;
+#endif
+    }
+
+    // Position of the first free slot on the probe sequence of the given hash
+    std::size_t FindFree(std::size_t hash) const {
+        std::size_t group = H1(hash) & _mask;
+        for (std::size_t step = 1;; step++) {
+            uint32_t free = MatchFree(&_ctrl[group * kGroupWidth]);
+            if (free != 0) {
+                return group * kGroupWidth + __builtin_ctz(free);
+            }
+            group = (group + step) & _mask;
+        }
+    }
+
+    // Rehash whole index into a new table. Table doubles unless most of the used space are tombstones
+    void Grow() {
+        std::size_t capacity = _slots.size();
+        if (capacity == 0) {
+            capacity = kGroupWidth;
+        } else if (_size * 2 >= MaxLoad(capacity)) {
+            capacity *= 2;
+        }
+
+        std::vector<int8_t> ctrl(capacity, kEmpty);
+        std::vector<T> slots(capacity);
+        ctrl.swap(_ctrl);
+        slots.swap(_slots);
+        _mask = capacity / kGroupWidth - 1;
+        _growth_left = MaxLoad(capacity) - _size;
+
+        for (std::size_t i = 0; i < ctrl.size(); i++) {
+            if (ctrl[i] >= 0) {
+                std::size_t hash = _traits.Hash(slots[i]);
+                std::size_t pos = FindFree(hash);
+                _ctrl[pos] = H2(hash);
+                _slots[pos] = slots[i];
+            }
+        }
+    }
+
+    // Maximum number of used slots (either full or deleted) the table could have, 7/8 of the capacity
+    static std::size_t MaxLoad(std::size_t capacity) { return capacity - capacity / 8; }
+
+    Traits _traits;
+
+    // Number of keys in the index
+    std::size_t _size;
+
+    // How many empty slots could be used before the index must be rehashed
+    std::size_t _growth_left;
+
+    // Number of groups minus one, number of groups is always power of two
+    std::size_t _mask;
+
+    // Control bytes, one per slot
+    std::vector<int8_t> _ctrl;
+
+    // Slots
+    std::vector<T> _slots;
+};
+
+template <typename T, typename Traits> constexpr std::size_t SwissIndex<T, Traits>::kGroupWidth;
+template <typename T, typename Traits> constexpr int8_t SwissIndex<T, Traits>::kEmpty;
+template <typename T, typename Traits> constexpr int8_t SwissIndex<T, Traits>::kDeleted;
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SWISS_INDEX_H
@@ -0,0 +1,99 @@
+#ifndef AFINA_STORAGE_THREAD_SAFE_CLOCK_H
+#define AFINA_STORAGE_THREAD_SAFE_CLOCK_H
+
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include <afina/concurrency/SharedMutex.h>
+
+#include "SimpleClock.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleClock thread safe version
+ * Get only sets entry reference bit, so all reads run concurrently under the shared lock. Modifications are
+ * serialized by the exclusive one
+ */
+class ThreadSafeClock : public SimpleClock {
+public:
+    ThreadSafeClock(size_t max_size = 1024) : SimpleClock(max_size) {}
+    ~ThreadSafeClock() {}
+
+    // see SimpleClock.h
+    bool Put(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::Put(key, value);
+    }
+
+    // see SimpleClock.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::PutIfAbsent(key, value);
+    }
+
+    // see SimpleClock.h
+    bool Set(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::Set(key, value);
+    }
+
+    // see SimpleClock.h
+    bool Delete(const std::string &key) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::Delete(key);
+    }
+
+    // see SimpleClock.h
+    bool Get(const std::string &key, std::string &value) override {
+        Concurrency::SharedLock<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::Get(key, value);
+    }
+
+    // see SimpleClock.h
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::Update(key, update);
+    }
+
+    // see SimpleClock.h
+    bool Append(const std::string &key, const std::string &data, uint64_t &version) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::Append(key, data, version);
+    }
+
+    // see SimpleClock.h
+    bool Prepend(const std::string &key, const std::string &data, uint64_t &version) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::Prepend(key, data, version);
+    }
+
+    // see SimpleClock.h
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) override {
+        Concurrency::SharedLock<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::GetAndTouch(key, expire, value);
+    }
+
+    // see SimpleClock.h
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) override {
+        Concurrency::SharedLock<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::GetVersion(key, value, version);
+    }
+
+    // see SimpleClock.h
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) override {
+        std::lock_guard<Concurrency::SharedMutex> lock(_lock);
+        return SimpleClock::CompareAndSet(key, value, expire, version);
+    }
+
+private:
+    Concurrency::SharedMutex _lock;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_THREAD_SAFE_CLOCK_H
@@ -0,0 +1,57 @@
+#include "ThreadSafeSimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+constexpr std::size_t ThreadSafeSimplLRU::kEvictSlice;
+
+// See ThreadSafeSimpleLRU.h
+void ThreadSafeSimplLRU::Start() {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_running) {
+        return;
+    }
+    _running = true;
+    _evictor = std::thread(&ThreadSafeSimplLRU::OnRun, this);
+}
+
+// See ThreadSafeSimpleLRU.h
+void ThreadSafeSimplLRU::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _running = false;
+    }
+    _evict_cv.notify_one();
+    if (_evictor.joinable()) {
+        _evictor.join();
+    }
+}
+
+// See ThreadSafeSimpleLRU.h
+void ThreadSafeSimplLRU::Stats(std::map<std::string, std::string> &stats) {
+    std::lock_guard<std::mutex> lock(_lock);
+    stats["lru_items_bytes"] = std::to_string(currSize);
+    stats["lru_limit_bytes"] = std::to_string(_max_size);
+    stats["lru_high_watermark_bytes"] = std::to_string(_high_watermark);
+    stats["lru_low_watermark_bytes"] = std::to_string(_low_watermark);
+    stats["lru_background_evicted"] = std::to_string(_background_evicted);
+}
+
+// See ThreadSafeSimpleLRU.h
+void ThreadSafeSimplLRU::OnRun() {
+    std::unique_lock<std::mutex> lock(_lock);
+    while (_running) {
+        _evict_cv.wait(lock, [this] { return !_running || currSize > _high_watermark; });
+
+        // Requests waiting for the lock get it between slices, so none of them waits for the whole eviction
+        while (_running && currSize > _low_watermark) {
+            _background_evicted += SimpleLRU::Shrink(_low_watermark, kEvictSlice);
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
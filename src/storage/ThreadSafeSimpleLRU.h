@@ -1,9 +1,11 @@
 #ifndef AFINA_STORAGE_THREAD_SAFE_SIMPLE_LRU_H
 #define AFINA_STORAGE_THREAD_SAFE_SIMPLE_LRU_H
 
+#include <condition_variable>
 #include <map>
 #include <mutex>
 #include <string>
+#include <thread>
 
 #include "SimpleLRU.h"
 
@@ -12,46 +14,197 @@ namespace Backend {
 
 /**
  * # SimpleLRU thread safe version
+ * Serializes all operations on a single mutex
  *
- *
+ * Once started, keeps free headroom with the background thread: as soon as size crosses the high watermark,
+ * least recently used nodes get evicted in small slices until size drops below the low watermark. Writes only
+ * evict by themselves if the headroom isn't enough for them, so most of them never pay for the eviction.
  */
 class ThreadSafeSimplLRU : public SimpleLRU {
 public:
-    ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
-    ~ThreadSafeSimplLRU() {}
+    ThreadSafeSimplLRU(size_t max_size = 1024)
+        : SimpleLRU(max_size), _high_watermark(max_size - max_size / 10), _low_watermark(max_size - max_size / 5),
+          _running(false), _background_evicted(0) {}
+    ~ThreadSafeSimplLRU() { Stop(); }
+
+    // Implements Afina::Storage interface
+    void Start() override;
+
+    // Implements Afina::Storage interface
+    void Stop() override;
 
     // see SimpleLRU.h
     bool Put(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
-        return SimpleLRU::Put(key, value);
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::Put(key, value);
+        Wake();
+        return result;
     }
 
     // see SimpleLRU.h
     bool PutIfAbsent(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
-        return SimpleLRU::PutIfAbsent(key, value);
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::PutIfAbsent(key, value);
+        Wake();
+        return result;
     }
 
     // see SimpleLRU.h
     bool Set(const std::string &key, const std::string &value) override {
-        // TODO: sinchronization
-        return SimpleLRU::Set(key, value);
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::Set(key, value);
+        Wake();
+        return result;
     }
 
     // see SimpleLRU.h
     bool Delete(const std::string &key) override {
-        // TODO: sinchronization
+        std::lock_guard<std::mutex> lock(_lock);
         return SimpleLRU::Delete(key);
     }
 
     // see SimpleLRU.h
     bool Get(const std::string &key, std::string &value) override {
-        // TODO: sinchronization
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleLRU::Get(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, Value &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
         return SimpleLRU::Get(key, value);
     }
 
+    // see SimpleLRU.h
+    std::size_t MultiGet(const std::string *keys, std::size_t count, Value *values) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleLRU::MultiGet(keys, count, values);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const Key &key, Value &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleLRU::Get(key, value);
+    }
+
+    // see SimpleLRU.h
+    std::size_t MultiGet(const Key *keys, std::size_t count, Value *values) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleLRU::MultiGet(keys, count, values);
+    }
+
+    // see SimpleLRU.h
+    std::size_t MultiGet(const Key *keys, const uint32_t *order, std::size_t count, Value *values) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleLRU::MultiGet(keys, order, count, values);
+    }
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, uint32_t expire) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::Put(key, value, expire);
+        Wake();
+        return result;
+    }
+
+    // see SimpleLRU.h
+    bool Put(const Key &key, const std::string &value, uint32_t expire) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::Put(key, value, expire);
+        Wake();
+        return result;
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t expire) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::PutIfAbsent(key, value, expire);
+        Wake();
+        return result;
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, uint32_t expire) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::Set(key, value, expire);
+        Wake();
+        return result;
+    }
+
+    // see SimpleLRU.h
+    bool Update(const std::string &key,
+                const std::function<bool(const std::string &value, std::string &result)> &update) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::Update(key, update);
+        Wake();
+        return result;
+    }
+
+    // see SimpleLRU.h
+    bool Append(const std::string &key, const std::string &data, uint64_t &version) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::Append(key, data, version);
+        Wake();
+        return result;
+    }
+
+    // see SimpleLRU.h
+    bool Prepend(const std::string &key, const std::string &data, uint64_t &version) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::Prepend(key, data, version);
+        Wake();
+        return result;
+    }
+
+    // see SimpleLRU.h
+    bool GetAndTouch(const std::string &key, uint32_t expire, Value &value) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleLRU::GetAndTouch(key, expire, value);
+    }
+
+    // see SimpleLRU.h
+    bool GetVersion(const std::string &key, Value &value, uint64_t &version) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        return SimpleLRU::GetVersion(key, value, version);
+    }
+
+    // see SimpleLRU.h
+    bool CompareAndSet(const std::string &key, const std::string &value, uint32_t expire, uint64_t &version) override {
+        std::lock_guard<std::mutex> lock(_lock);
+        bool result = SimpleLRU::CompareAndSet(key, value, expire, version);
+        Wake();
+        return result;
+    }
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override;
+
 private:
-    // TODO: sinchronization primitives
+    // Number of nodes evicted by the background thread at once, lock is released between slices
+    static constexpr std::size_t kEvictSlice = 32;
+
+    // Wakes background thread up if size is above the high watermark, lock must be held
+    void Wake() {
+        if (_running && currSize > _high_watermark) {
+            _evict_cv.notify_one();
+        }
+    }
+
+    // Background eviction loop
+    void OnRun();
+
+    std::mutex _lock;
+
+    // Background eviction starts once size is above the high watermark and stops at the low one
+    const std::size_t _high_watermark;
+    const std::size_t _low_watermark;
+
+    bool _running;
+    std::thread _evictor;
+    std::condition_variable _evict_cv;
+
+    // Number of nodes evicted by the background thread
+    std::size_t _background_evicted;
 };
 
 } // namespace Backend
@@ -0,0 +1,98 @@
+#include "TinyLFU.h"
+
+namespace Afina {
+namespace Backend {
+
+// Sketch width estimation is based on the assumption of 32 bytes per entry on average
+TinyLFU::TinyLFU(size_t max_size, size_t window_percent)
+    : _max_size(max_size), _window_size(max_size * window_percent / 100), _window(max_size),
+      _main(max_size - _window_size), _sketch(max_size / 32), _hits(0), _misses(0), _admitted(0), _rejected(0) {}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Put(const std::string &key, const std::string &value) {
+    if (key.empty() || key.size() + value.size() > _max_size - _window_size) {
+        return false;
+    }
+
+    _sketch.Increment(KeyHash(key));
+    if (_main.Contains(key)) {
+        return _main.Put(key, value);
+    }
+
+    _window.Put(key, value);
+    Balance();
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value) {
+    if (_main.Contains(key) || _window.Contains(key)) {
+        return false;
+    }
+    return TinyLFU::Put(key, value);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Set(const std::string &key, const std::string &value) {
+    if (!_main.Contains(key) && !_window.Contains(key)) {
+        return false;
+    }
+    return TinyLFU::Put(key, value);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Delete(const std::string &key) { return _window.Delete(key) || _main.Delete(key); }
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Get(const std::string &key, std::string &value) {
+    Value shared;
+    if (!TinyLFU::Get(key, shared)) {
+        return false;
+    }
+    value = *shared;
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Get(const std::string &key, Value &value) {
+    _sketch.Increment(KeyHash(key));
+    if (_window.Get(key, value) || _main.Get(key, value)) {
+        _hits++;
+        return true;
+    }
+    _misses++;
+    return false;
+}
+
+// See Storage.h
+void TinyLFU::Stats(std::map<std::string, std::string> &stats) {
+    stats["get_hits"] = std::to_string(_hits);
+    stats["get_misses"] = std::to_string(_misses);
+    stats["tinylfu_admitted"] = std::to_string(_admitted);
+    stats["tinylfu_rejected"] = std::to_string(_rejected);
+    stats["tinylfu_window_bytes"] = std::to_string(_window.Size());
+    stats["tinylfu_main_bytes"] = std::to_string(_main.Size());
+}
+
+// See TinyLFU.h
+void TinyLFU::Balance() {
+    std::string key;
+    Value value;
+    while (_window.Size() > _window_size && _window.Pop(key, value)) {
+        // Until main LRU is full there is a room for everybody, then candidate replaces main victim only if
+        // it is used more often
+        Key candidate(key);
+        const std::string *victim = _main.Oldest();
+        if (_main.Size() + key.size() + value->size() > _max_size - _window_size && victim != nullptr &&
+            _sketch.Estimate(candidate.hash) <= _sketch.Estimate(KeyHash(*victim))) {
+            _rejected++;
+            continue;
+        }
+
+        _admitted++;
+        _main.Put(candidate, value, 0);
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
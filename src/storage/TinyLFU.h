@@ -0,0 +1,72 @@
+#ifndef AFINA_STORAGE_TINY_LFU_H
+#define AFINA_STORAGE_TINY_LFU_H
+
+#include <map>
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "FrequencySketch.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # W-TinyLFU cache
+ * New keys get into small window LRU first. Keys evicted from the window are candidates to the main LRU, and
+ * candidate is admitted only if its estimated access frequency is higher than frequency of the main LRU victim.
+ * Otherwise candidate is dropped, so a scan of one-hit keys can't flush frequently used ones out of the cache.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class TinyLFU : public Afina::Storage {
+public:
+    TinyLFU(size_t max_size = 1024, size_t window_percent = 1);
+    ~TinyLFU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, Value &value) override;
+
+    // Implements Afina::Storage interface
+    void Stats(std::map<std::string, std::string> &stats) override;
+
+private:
+    // Moves keys which don't fit into window anymore to the main LRU, if admission allows
+    void Balance();
+
+    std::size_t _max_size;
+    std::size_t _window_size;
+
+    // Window LRU never evicts by itself, Balance keeps it in the window budget
+    SimpleLRU _window;
+    SimpleLRU _main;
+
+    FrequencySketch _sketch;
+
+    // Counters reported by stats
+    std::size_t _hits;
+    std::size_t _misses;
+    std::size_t _admitted;
+    std::size_t _rejected;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TINY_LFU_H
@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include <cstring>
+#include <vector>
+
+#include <afina/allocator/Error.h>
+#include <afina/allocator/Simple.h>
+#include <afina/allocator/Slab.h>
+
+using namespace std;
+using namespace Afina::Allocator;
+
+static char area[65536];
+
+TEST(SlabTest, ChunksOfSameClassReused) {
+    Simple memory(area, sizeof(area));
+    Slab slab(memory, 4096);
+
+    void *a = slab.alloc(100);
+    void *b = slab.alloc(100);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(slab.ChunkSize(100), slab.ChunkSize(101));
+    EXPECT_GE(slab.ChunkSize(100), 100);
+
+    slab.free(a);
+    EXPECT_EQ(a, slab.alloc(100));
+
+    vector<Slab::class_stats> classes = slab.Classes();
+    size_t pages = 0, used = 0;
+    for (auto &cls : classes) {
+        pages += cls.pages;
+        used += cls.used_chunks;
+    }
+    EXPECT_EQ(1, pages);
+    EXPECT_EQ(2, used);
+}
+
+TEST(SlabTest, NoMemory) {
+    Simple memory(area, sizeof(area));
+    Slab slab(memory, 4096);
+
+    vector<void *> chunks;
+    try {
+        for (int i = 0; i < 1000; i++) {
+            chunks.push_back(slab.alloc(200));
+            memset(chunks.back(), i, 200);
+        }
+        EXPECT_TRUE(false);
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::NoMemory);
+    }
+
+    // Pages are given back once all their chunks are free, so memory could be used by another class
+    EXPECT_LE(slab.Footprint(), sizeof(area));
+    for (void *p : chunks) {
+        slab.free(p);
+    }
+    EXPECT_LE(slab.Footprint(), 4096);
+    for (int i = 0; i < 100; i++) {
+        slab.alloc(400);
+    }
+}
+
+TEST(SlabTest, LargeAllocation) {
+    Simple memory(area, sizeof(area));
+    Slab slab(memory, 4096);
+
+    char *p = static_cast<char *>(slab.alloc(10000));
+    memset(p, 1, 10000);
+    EXPECT_EQ(1, slab.LargeCount());
+    EXPECT_EQ(10000, slab.LargeBytes());
+
+    slab.free(p);
+    EXPECT_EQ(0, slab.LargeCount());
+    EXPECT_EQ(0, slab.Footprint());
+}
+
+TEST(SlabTest, MovePage) {
+    Simple memory(area, sizeof(area));
+    Slab slab(memory, 4096);
+    size_t small = slab.ClassOf(100), big = slab.ClassOf(1000);
+
+    vector<void *> chunks;
+    try {
+        while (true) {
+            chunks.push_back(slab.alloc(100));
+        }
+    } catch (AllocError &e) {
+        EXPECT_EQ(e.getType(), AllocErrorType::NoMemory);
+    }
+    EXPECT_THROW(slab.alloc(1000), AllocError);
+
+    // Page of the small class goes to the big one once all its chunks are free
+    EXPECT_FALSE(slab.Move(small, big));
+    for (size_t i = 0; slab.Moving(small); i++) {
+        slab.free(chunks[i]);
+    }
+    EXPECT_EQ(1, slab.MovedPages());
+    EXPECT_EQ(1, slab.Classes()[big].pages);
+    EXPECT_NO_THROW(slab.alloc(1000));
+}
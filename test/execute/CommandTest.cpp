@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/execute/Append.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Decr.h>
+#include <afina/execute/Gat.h>
+#include <afina/execute/Gets.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Keys.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Touch.h>
+
+#include "storage/OrderedLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina::Backend;
+using namespace Afina::Execute;
+using namespace std;
+
+TEST(CommandTest, IncrDecr) {
+    SimpleLRU storage(1024);
+
+    string out;
+    Incr("counter", 1).Execute(storage, "", out);
+    EXPECT_EQ("NOT_FOUND", out);
+
+    // Increment wraps around, decrement stops at zero
+    EXPECT_TRUE(storage.Put("counter", "18446744073709551614"));
+    Incr("counter", 3).Execute(storage, "", out);
+    EXPECT_EQ("1", out);
+    Decr("counter", 5).Execute(storage, "", out);
+    EXPECT_EQ("0", out);
+    EXPECT_TRUE(storage.Get("counter", out));
+    EXPECT_EQ("0", out);
+
+    EXPECT_TRUE(storage.Put("text", "12a"));
+    Incr("text", 1).Execute(storage, "", out);
+    EXPECT_EQ("CLIENT_ERROR cannot increment or decrement non-numeric value", out);
+    EXPECT_TRUE(storage.Put("text", "18446744073709551616"));
+    Decr("text", 1).Execute(storage, "", out);
+    EXPECT_EQ("CLIENT_ERROR cannot increment or decrement non-numeric value", out);
+}
+
+TEST(CommandTest, ConcurrentIncr) {
+    ThreadSafeSimplLRU storage(1024);
+    EXPECT_TRUE(storage.Put("counter", "0"));
+
+    vector<thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&storage]() {
+            string result;
+            for (int i = 0; i < 1000; i++) {
+                Incr("counter", 1).Execute(storage, "", result);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    string value;
+    EXPECT_TRUE(storage.Get("counter", value));
+    EXPECT_EQ("4000", value);
+}
+
+TEST(CommandTest, TouchAndGat) {
+    SimpleLRU storage(1024);
+
+    string out;
+    Touch("foo", 100).Execute(storage, "", out);
+    EXPECT_EQ("NOT_FOUND", out);
+
+    EXPECT_TRUE(storage.Put("foo", "fooval"));
+    EXPECT_TRUE(storage.Put("bar", "barval"));
+    Touch("foo", 100).Execute(storage, "", out);
+    EXPECT_EQ("TOUCHED", out);
+
+    Gat(100, {"foo", "baz", "bar"}).Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 0 6\r\nfooval\r\nVALUE bar 0 6\r\nbarval\r\nEND", out);
+
+    // Negative expiration time makes items expired right away
+    Gat(-1, {"foo"}).Execute(storage, "", out);
+    EXPECT_EQ("VALUE foo 0 6\r\nfooval\r\nEND", out);
+    EXPECT_FALSE(storage.Get("foo", out));
+}
+
+TEST(CommandTest, GetsAndCas) {
+    SimpleLRU storage(1024);
+
+    string out;
+    Cas("foo", 0, 0, 1).Execute(storage, "new", out);
+    EXPECT_EQ("NOT_FOUND", out);
+
+    EXPECT_TRUE(storage.Put("foo", "fooval"));
+    Gets({"foo", "bar"}).Execute(storage, "", out);
+    ASSERT_EQ(0, out.find("VALUE foo 0 6 "));
+    uint64_t version = stoull(out.substr(14, out.find("\r\n") - 14));
+    EXPECT_EQ("VALUE foo 0 6 " + to_string(version) + "\r\nfooval\r\nEND", out);
+
+    // Version given out is good only once
+    Cas("foo", 0, 0, version).Execute(storage, "new", out);
+    EXPECT_EQ("STORED", out);
+    Cas("foo", 0, 0, version).Execute(storage, "newer", out);
+    EXPECT_EQ("EXISTS", out);
+    EXPECT_TRUE(storage.Get("foo", out));
+    EXPECT_EQ("new", out);
+
+    // Value doesn't fit, but version matches
+    Gets({"foo"}).Execute(storage, "", out);
+    version = stoull(out.substr(14, out.find("\r\n") - 14));
+    Cas("foo", 0, 0, version).Execute(storage, string(2048, 'x'), out);
+    EXPECT_EQ("NOT_STORED", out);
+
+    // Storage which doesn't keep versions refuses both
+    OrderedLRU unversioned(1024);
+    EXPECT_TRUE(unversioned.Put("foo", "fooval"));
+    Gets({"foo"}).Execute(unversioned, "", out);
+    EXPECT_EQ("SERVER_ERROR gets is not supported by storage", out);
+    Cas("foo", 0, 0, 1).Execute(unversioned, "new", out);
+    EXPECT_EQ("SERVER_ERROR cas is not supported by storage", out);
+}
+
+TEST(CommandTest, AppendPrepend) {
+    SimpleLRU storage(1024);
+
+    string out;
+    Append("foo", 0, 0).Execute(storage, "val", out);
+    EXPECT_EQ("NOT_STORED", out);
+
+    EXPECT_TRUE(storage.Put("foo", "val"));
+    Append("foo", 0, 0).Execute(storage, "ue", out);
+    EXPECT_EQ("STORED", out);
+    Prepend("foo", 0, 0).Execute(storage, "foo", out);
+    EXPECT_EQ("STORED", out);
+
+    EXPECT_TRUE(storage.Get("foo", out));
+    EXPECT_EQ("foovalue", out);
+}
+
+TEST(CommandTest, KeysBatches) {
+    OrderedLRU storage(1024 * 1024);
+    string out;
+    Keys("").Execute(storage, "", out);
+    EXPECT_EQ("END", out);
+
+    EXPECT_TRUE(storage.Put("user:1", "a"));
+    EXPECT_TRUE(storage.Put("user:2", "b"));
+    EXPECT_TRUE(storage.Put("other", "c"));
+    Keys("user:").Execute(storage, "", out);
+    EXPECT_EQ("KEY user:1\r\nKEY user:2\r\nEND", out);
+
+    // Wide prefix is sent in bounded buffers and cut at the limit
+    for (size_t i = 0; i < Keys::kMaxKeys + 10; i++) {
+        EXPECT_TRUE(storage.Put("many:" + to_string(100000 + i), "v"));
+    }
+    Response response;
+    Keys("many:").Execute(storage, "", response);
+
+    vector<struct iovec> iov;
+    response.Gather(iov);
+    EXPECT_LT(1, iov.size());
+    for (auto &buffer : iov) {
+        EXPECT_GT(Keys::kBatchSize + 64, buffer.iov_len);
+    }
+
+    out = response.str();
+    EXPECT_EQ(Keys::kMaxKeys, size_t(count(out.begin(), out.end(), '\n')) - 1);
+    EXPECT_EQ(out.size() - 16, out.rfind("\r\nTRUNCATED\r\nEND"));
+}
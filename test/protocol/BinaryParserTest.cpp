@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <protocol/Binary.h>
+#include <protocol/BinaryCommand.h>
+#include <protocol/BinaryParser.h>
+#include <storage/SimpleLRU.h>
+
+using namespace Afina;
+using namespace Afina::Protocol;
+
+// Binary request with the given fields
+static std::string Request(uint8_t opcode, const std::string &key, const std::string &extras = "",
+                           const std::string &value = "", uint32_t opaque = 0, uint64_t cas = 0) {
+    std::string request(Binary::kHeaderSize, '\0');
+    request[0] = char(Binary::kRequestMagic);
+    request[1] = char(opcode);
+    Binary::Store(&request[2], 2, key.size());
+    request[4] = char(extras.size());
+    Binary::Store(&request[8], 4, extras.size() + key.size() + value.size());
+    Binary::Store(&request[12], 4, opaque);
+    Binary::Store(&request[16], 8, cas);
+    return request + extras + key + value;
+}
+
+// Parses request and runs it against storage, gives out the whole response
+static std::string Exchange(Storage &storage, const std::string &request) {
+    BinaryParser parser;
+    size_t parsed = 0;
+    EXPECT_TRUE(parser.Parse(request.data(), request.size(), parsed));
+
+    size_t body_size = 0;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(body_size);
+    EXPECT_FALSE(cmd == nullptr);
+    EXPECT_EQ(request.size(), parsed + body_size);
+
+    std::string out;
+    cmd->Execute(storage, request.substr(parsed), out);
+    return out;
+}
+
+static uint16_t Status(const std::string &response) { return Binary::Load(response.data() + 6, 2); }
+
+static std::string Value(const std::string &response) {
+    size_t skip = Binary::kHeaderSize + uint8_t(response[4]) + Binary::Load(response.data() + 2, 2);
+    return response.substr(skip);
+}
+
+TEST(BinaryParserTest, SplitRequest) {
+    std::string request = Request(Binary::oSet, "foo", std::string(8, '\0'), "value", 42, 7);
+
+    // Header, extras and key byte by byte, value is left to the caller
+    BinaryParser parser;
+    size_t parsed = 0;
+    size_t head = Binary::kHeaderSize + 8 + 3;
+    for (size_t i = 0; i + 1 < head; i++) {
+        ASSERT_FALSE(parser.Parse(&request[i], 1, parsed));
+        ASSERT_EQ(1, parsed);
+    }
+    ASSERT_TRUE(parser.Parse(&request[head - 1], request.size() - head + 1, parsed));
+    ASSERT_EQ(1, parsed);
+    ASSERT_EQ(Binary::oSet, parser.Opcode());
+
+    size_t body_size = 0;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(body_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(5, body_size);
+
+    BinaryCommand *set = reinterpret_cast<BinaryCommand *>(cmd.get());
+    ASSERT_EQ("foo", set->key());
+    ASSERT_EQ(8, set->extras().size());
+    ASSERT_EQ(42, set->opaque());
+    ASSERT_EQ(7, set->cas());
+
+    // Request without extras and key is complete right after the header
+    parser.Reset();
+    request = Request(Binary::oNoop, "");
+    ASSERT_TRUE(parser.Parse(request.data(), request.size(), parsed));
+    ASSERT_EQ(Binary::kHeaderSize, parsed);
+}
+
+TEST(BinaryParserTest, BrokenFraming) {
+    BinaryParser parser;
+    size_t parsed = 0;
+
+    std::string request = Request(Binary::oGet, "foo");
+    request[0] = 'g';
+    ASSERT_THROW(parser.Parse(request.data(), request.size(), parsed), std::runtime_error);
+
+    parser.Reset();
+    request = Request(Binary::oGet, "foo");
+    Binary::Store(&request[8], 4, 2);
+    ASSERT_THROW(parser.Parse(request.data(), request.size(), parsed), std::runtime_error);
+}
+
+TEST(BinaryParserTest, Commands) {
+    Backend::SimpleLRU storage(1024);
+    std::string flags(8, '\0');
+
+    std::string out = Exchange(storage, Request(Binary::oSet, "foo", flags, "bar", 5));
+    ASSERT_EQ(Binary::kHeaderSize, out.size());
+    ASSERT_EQ(Binary::kResponseMagic, uint8_t(out[0]));
+    ASSERT_EQ(Binary::sOk, Status(out));
+    ASSERT_EQ(5, Binary::Load(out.data() + 12, 4));
+    uint64_t cas = Binary::Load(out.data() + 16, 8);
+    ASSERT_NE(0, cas);
+
+    // Get sends flags, cas and value, GetK adds the key
+    out = Exchange(storage, Request(Binary::oGet, "foo"));
+    ASSERT_EQ(Binary::sOk, Status(out));
+    ASSERT_EQ(4, out[4]);
+    ASSERT_EQ("bar", Value(out));
+    ASSERT_EQ(cas, Binary::Load(out.data() + 16, 8));
+
+    out = Exchange(storage, Request(Binary::oGetK, "foo"));
+    ASSERT_EQ("foo", out.substr(Binary::kHeaderSize + 4, 3));
+    ASSERT_EQ("bar", Value(out));
+
+    // Quiet miss sends nothing, loud one sends an error
+    ASSERT_EQ("", Exchange(storage, Request(Binary::oGetQ, "none")));
+    out = Exchange(storage, Request(Binary::oGet, "none"));
+    ASSERT_EQ(Binary::sKeyNotFound, Status(out));
+    ASSERT_EQ("Not found", Value(out));
+
+    // Set with cas works only for the current version
+    out = Exchange(storage, Request(Binary::oSet, "foo", flags, "baz", 0, cas + 1));
+    ASSERT_EQ(Binary::sKeyExists, Status(out));
+    out = Exchange(storage, Request(Binary::oSet, "foo", flags, "baz", 0, cas));
+    ASSERT_EQ(Binary::sOk, Status(out));
+    uint64_t stored = Binary::Load(out.data() + 16, 8);
+    ASSERT_NE(cas, stored);
+    ASSERT_EQ(stored, Binary::Load(Exchange(storage, Request(Binary::oGet, "foo")).data() + 16, 8));
+
+    // Touch and gat send the version too
+    std::string expire(4, '\0');
+    ASSERT_EQ(stored, Binary::Load(Exchange(storage, Request(Binary::oTouch, "foo", expire)).data() + 16, 8));
+    ASSERT_EQ(stored, Binary::Load(Exchange(storage, Request(Binary::oGat, "foo", expire)).data() + 16, 8));
+
+    ASSERT_EQ(Binary::sKeyExists, Status(Exchange(storage, Request(Binary::oAdd, "foo", flags, "x"))));
+    ASSERT_EQ(Binary::sKeyNotFound, Status(Exchange(storage, Request(Binary::oReplace, "new", flags, "x"))));
+    ASSERT_EQ("", Exchange(storage, Request(Binary::oAppendQ, "foo", "", "!")));
+    ASSERT_EQ("baz!", Value(Exchange(storage, Request(Binary::oGet, "foo"))));
+
+    // Append gives out the version of its own write
+    out = Exchange(storage, Request(Binary::oAppend, "foo", "", "?"));
+    ASSERT_EQ(Binary::sOk, Status(out));
+    stored = Binary::Load(out.data() + 16, 8);
+    out = Exchange(storage, Request(Binary::oGet, "foo"));
+    ASSERT_EQ("baz!?", Value(out));
+    ASSERT_EQ(stored, Binary::Load(out.data() + 16, 8));
+    ASSERT_EQ(Binary::sInvalidArguments, Status(Exchange(storage, Request(Binary::oSet, "foo", "", "x"))));
+
+    ASSERT_EQ(Binary::sOk, Status(Exchange(storage, Request(Binary::oDelete, "foo"))));
+    ASSERT_EQ(Binary::sKeyNotFound, Status(Exchange(storage, Request(Binary::oDelete, "foo"))));
+    ASSERT_EQ(Binary::sUnknownCommand, Status(Exchange(storage, Request(0x42, ""))));
+}
+
+TEST(BinaryParserTest, Arithmetic) {
+    Backend::SimpleLRU storage(1024);
+
+    // Extras are delta, initial value and expiration, all ones expiration means item must exist
+    std::string extras(20, '\0');
+    Binary::Store(&extras[0], 8, 5);
+    Binary::Store(&extras[8], 8, 10);
+    Binary::Store(&extras[16], 4, UINT32_MAX);
+    ASSERT_EQ(Binary::sKeyNotFound, Status(Exchange(storage, Request(Binary::oIncrement, "counter", extras))));
+
+    Binary::Store(&extras[16], 4, 0);
+    std::string out = Exchange(storage, Request(Binary::oIncrement, "counter", extras));
+    ASSERT_EQ(Binary::sOk, Status(out));
+    ASSERT_EQ(10, Binary::Load(Value(out).data(), 8));
+
+    out = Exchange(storage, Request(Binary::oIncrement, "counter", extras));
+    ASSERT_EQ(15, Binary::Load(Value(out).data(), 8));
+
+    Binary::Store(&extras[0], 8, 100);
+    out = Exchange(storage, Request(Binary::oDecrement, "counter", extras));
+    ASSERT_EQ(0, Binary::Load(Value(out).data(), 8));
+
+    std::string value;
+    ASSERT_TRUE(storage.Get("counter", value));
+    ASSERT_EQ("0", value);
+
+    ASSERT_TRUE(storage.Put("text", "abc"));
+    ASSERT_EQ(Binary::sNonNumeric, Status(Exchange(storage, Request(Binary::oIncrement, "text", extras))));
+}
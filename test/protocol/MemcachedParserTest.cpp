@@ -1,12 +1,21 @@
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <memory>
 #include <string>
 
 #include <afina/execute/Add.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Decr.h>
+#include <afina/execute/Error.h>
+#include <afina/execute/Gat.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Gets.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Keys.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
 
 #include <protocol/Parser.h>
 
@@ -58,6 +67,24 @@ TEST(MemcachedParserTest, SimpleAdd) {
     ASSERT_EQ(-1, tmp->expire());
 }
 
+// Verify expiration time of all digits is accumulated, not just the first one
+TEST(MemcachedParserTest, MultiDigitExpire) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("set foo 0 3600 3\r\nbar\r\n", consumed));
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(3600, reinterpret_cast<Execute::Set *>(cmd.get())->expire());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("add foo 0 -120 3\r\nbar\r\n", consumed));
+    cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(-120, reinterpret_cast<Execute::Add *>(cmd.get())->expire());
+}
+
 // Verify simple get command passed in a single string
 TEST(MemcachedParserTest, SimpleGet) {
     Protocol::Parser parser;
@@ -81,6 +108,36 @@ TEST(MemcachedParserTest, SimpleGet) {
     ASSERT_EQ("super_long_key", keys[2]);
 }
 
+// Verify tokens split between reads survive reuse of the read buffer
+TEST(MemcachedParserTest, SplitTokens) {
+    Protocol::Parser parser;
+
+    char buffer[64];
+    size_t consumed = 0;
+    std::strcpy(buffer, "ge");
+    ASSERT_FALSE(parser.Parse(buffer, std::strlen(buffer), consumed));
+    ASSERT_EQ(2, consumed);
+
+    std::strcpy(buffer, "t key1 ke");
+    ASSERT_FALSE(parser.Parse(buffer, std::strlen(buffer), consumed));
+    ASSERT_EQ(9, consumed);
+
+    std::strcpy(buffer, "y2 key3\r\nset");
+    ASSERT_TRUE(parser.Parse(buffer, std::strlen(buffer), consumed));
+    ASSERT_EQ(9, consumed);
+    ASSERT_EQ("get", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+
+    std::vector<std::string> keys = reinterpret_cast<Execute::Get *>(cmd.get())->keys();
+    ASSERT_EQ(3, keys.size());
+    ASSERT_EQ("key1", keys[0]);
+    ASSERT_EQ("key2", keys[1]);
+    ASSERT_EQ("key3", keys[2]);
+}
+
 TEST(MemcachedParserTest, Stats) {
     Protocol::Parser parser;
 
@@ -98,3 +155,224 @@ TEST(MemcachedParserTest, Stats) {
     Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd.get());
     ASSERT_FALSE(tmp == nullptr);
 }
+
+TEST(MemcachedParserTest, Keys) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("keys user:1\r\n", consumed));
+    ASSERT_EQ(13, consumed);
+    ASSERT_EQ("keys", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(0, value_size);
+    ASSERT_EQ("user:1", reinterpret_cast<Execute::Keys *>(cmd.get())->prefix());
+
+    // Prefix could be omitted
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("keys\r\n", consumed));
+    ASSERT_EQ(6, consumed);
+    cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ("", reinterpret_cast<Execute::Keys *>(cmd.get())->prefix());
+}
+
+TEST(MemcachedParserTest, Arithmetic) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("incr counter 18446744073709551615\r\n", consumed));
+    ASSERT_EQ(35, consumed);
+    ASSERT_EQ("incr", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(0, value_size);
+    ASSERT_EQ("counter", reinterpret_cast<Execute::Incr *>(cmd.get())->key());
+    ASSERT_EQ(UINT64_MAX, reinterpret_cast<Execute::Incr *>(cmd.get())->delta());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("decr counter 7\r\n", consumed));
+    cmd = parser.Build(value_size);
+    ASSERT_EQ(7, reinterpret_cast<Execute::Decr *>(cmd.get())->delta());
+
+    // Delta is unsigned and must fit into 64 bits
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("incr counter -1\r\n", consumed));
+    ASSERT_STREQ(Protocol::Parser::kBadFormat, parser.Error());
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("incr counter 18446744073709551616\r\n", consumed));
+    ASSERT_EQ(35, consumed);
+    ASSERT_STREQ(Protocol::Parser::kBadFormat, parser.Error());
+}
+
+TEST(MemcachedParserTest, TouchAndGat) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("touch foo -1\r\n", consumed));
+    ASSERT_EQ(14, consumed);
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ("foo", reinterpret_cast<Execute::Touch *>(cmd.get())->key());
+    ASSERT_EQ(-1, reinterpret_cast<Execute::Touch *>(cmd.get())->expire());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("gat 3600 foo bar\r\n", consumed));
+    ASSERT_EQ(18, consumed);
+    cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    Execute::Gat *gat = reinterpret_cast<Execute::Gat *>(cmd.get());
+    ASSERT_EQ(3600, gat->expire());
+    ASSERT_EQ(2, gat->keys().size());
+    ASSERT_EQ("bar", gat->keys()[1]);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("gat 2147483648 foo\r\n", consumed));
+    ASSERT_EQ(20, consumed);
+    cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_STREQ(Protocol::Parser::kBadFormat, reinterpret_cast<Execute::Error *>(cmd.get())->reply());
+}
+
+TEST(MemcachedParserTest, GetsAndCas) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("gets foo bar\r\n", consumed));
+    ASSERT_EQ(14, consumed);
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(2, reinterpret_cast<Execute::Gets *>(cmd.get())->keys().size());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("cas foo 3 100 6 12345678901234\r\nfooval\r\n", consumed));
+    ASSERT_EQ(32, consumed);
+    cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(6, value_size);
+
+    Execute::Cas *cas = reinterpret_cast<Execute::Cas *>(cmd.get());
+    ASSERT_EQ("foo", cas->key());
+    ASSERT_EQ(3, cas->flags());
+    ASSERT_EQ(100, cas->expire());
+    ASSERT_EQ(12345678901234, cas->version());
+
+    // Version is mandatory and can't be empty
+    for (const char *line : {"cas foo 0 0 1\r\n", "cas foo 0 0 1 \r\n"}) {
+        parser.Reset();
+        ASSERT_TRUE(parser.Parse(line, consumed)) << line;
+        ASSERT_EQ(std::strlen(line), consumed);
+        ASSERT_STREQ(Protocol::Parser::kBadFormat, parser.Error()) << line;
+    }
+}
+
+TEST(MemcachedParserTest, BadLineResync) {
+    Protocol::Parser parser;
+
+    // Whole bad line is consumed, commands following it are parsed as usual
+    std::string input("foo bar\r\nget a\r\n");
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse(input, consumed));
+    ASSERT_EQ(9, consumed);
+    ASSERT_STREQ(Protocol::Parser::kUnknownCommand, parser.Error());
+
+    size_t value_size = 1;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(0, value_size);
+    ASSERT_STREQ(Protocol::Parser::kUnknownCommand, reinterpret_cast<Execute::Error *>(cmd.get())->reply());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse(input.substr(consumed), consumed));
+    ASSERT_EQ(7, consumed);
+    ASSERT_EQ(nullptr, parser.Error());
+    cmd = parser.Build(value_size);
+    ASSERT_EQ("a", reinterpret_cast<Execute::Get *>(cmd.get())->keys()[0]);
+
+    // Bad line could be split between reads
+    parser.Reset();
+    ASSERT_FALSE(parser.Parse("set foo x", consumed));
+    ASSERT_EQ(9, consumed);
+    ASSERT_FALSE(parser.Parse("yz 0 3\r", consumed));
+    ASSERT_TRUE(parser.Parse("\nstats\r\n", consumed));
+    ASSERT_EQ(1, consumed);
+    ASSERT_STREQ(Protocol::Parser::kBadFormat, parser.Error());
+
+    // Command which has arguments but got none
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("get\r\n", consumed));
+    ASSERT_EQ(5, consumed);
+    ASSERT_STREQ(Protocol::Parser::kUnknownCommand, parser.Error());
+
+    // Line ends right after the key, skip stops at its own \n and doesn't eat the next command
+    const char *short_lines[] = {"set k\r\nget k\r\n", "incr k\r\nget k\r\n"};
+    for (const char *line : short_lines) {
+        input = line;
+        parser.Reset();
+        ASSERT_TRUE(parser.Parse(input, consumed)) << line;
+        ASSERT_EQ(input.find('\n') + 1, consumed) << line;
+        ASSERT_STREQ(Protocol::Parser::kBadFormat, parser.Error()) << line;
+
+        parser.Reset();
+        ASSERT_TRUE(parser.Parse(input.substr(consumed), consumed)) << line;
+        ASSERT_EQ(nullptr, parser.Error());
+        cmd = parser.Build(value_size);
+        ASSERT_EQ("k", reinterpret_cast<Execute::Get *>(cmd.get())->keys()[0]);
+    }
+
+    // Junk in the bytes count
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set k 0 0 3x\r\n", consumed));
+    ASSERT_EQ(14, consumed);
+    ASSERT_STREQ(Protocol::Parser::kBadFormat, parser.Error());
+
+    // Line ends right after flags, next command is still there
+    input = "set k 0 \r\nget a\r\n";
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse(input, consumed));
+    ASSERT_EQ(10, consumed);
+    ASSERT_STREQ(Protocol::Parser::kBadFormat, parser.Error());
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse(input.substr(consumed), consumed));
+    ASSERT_EQ(nullptr, parser.Error());
+
+    // Exptime which is not a number
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set k 0 x 0 1\r\n", consumed));
+    ASSERT_EQ(15, consumed);
+    ASSERT_STREQ(Protocol::Parser::kBadFormat, parser.Error());
+}
+
+TEST(MemcachedParserTest, CommandNames) {
+    Protocol::Parser parser;
+    size_t consumed = 0;
+
+    // Names which are prefixes or extensions of known ones
+    const char *unknown[] = {"se a\r\n", "sets a\r\n", "prepends a\r\n", "getsgets a\r\n", "GET a\r\n"};
+    for (const char *line : unknown) {
+        parser.Reset();
+        ASSERT_TRUE(parser.Parse(line, consumed)) << line;
+        ASSERT_EQ(std::strlen(line), consumed);
+        ASSERT_STREQ(Protocol::Parser::kUnknownCommand, parser.Error()) << line;
+    }
+
+    // Name split between reads
+    parser.Reset();
+    ASSERT_FALSE(parser.Parse("pre", consumed));
+    ASSERT_TRUE(parser.Parse("pend foo 0 0 3\r\n", consumed));
+    ASSERT_EQ(nullptr, parser.Error());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(3, value_size);
+    ASSERT_EQ("prepend", parser.Name());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <protocol/Scan.h>
+
+using namespace Afina;
+
+TEST(ScanTest, FindDelimiter) {
+    // Delimiter at every position of the vector-sized block and its tail, from every alignment
+    std::string buffer(100, 'x');
+    for (std::size_t begin = 0; begin < 8; begin++) {
+        for (std::size_t pos = begin; pos < buffer.size(); pos++) {
+            for (char delimiter : {' ', '\r'}) {
+                buffer[pos] = delimiter;
+                EXPECT_EQ(buffer.data() + pos, Protocol::FindDelimiter(buffer.data() + begin, buffer.data() + 100))
+                    << Protocol::DelimiterScanName() << " begin " << begin << " pos " << pos;
+                buffer[pos] = 'x';
+            }
+        }
+
+        const char *end = buffer.data() + buffer.size();
+        EXPECT_EQ(end, Protocol::FindDelimiter(buffer.data() + begin, end));
+    }
+
+    // Bytes beyond the end are never reported
+    buffer[40] = ' ';
+    EXPECT_EQ(buffer.data() + 39, Protocol::FindDelimiter(buffer.data(), buffer.data() + 39));
+    EXPECT_EQ(buffer.data() + 10, Protocol::FindDelimiter(buffer.data() + 10, buffer.data() + 10));
+}
+
+// Every implementation the CPU supports, not only the one FindDelimiter picked
+TEST(ScanTest, Implementations) {
+    struct implementation {
+        const char *(*find)(const char *begin, const char *end);
+        const char *name;
+    };
+    std::vector<implementation> implementations{{Protocol::FindDelimiterScalar, "scalar"}};
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        implementations.push_back({Protocol::FindDelimiterSse42, "sse4.2"});
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        implementations.push_back({Protocol::FindDelimiterAvx2, "avx2"});
+    }
+#endif
+
+    // Buffers are allocated of the exact size, so reads past the end are caught by sanitizers
+    for (const implementation &impl : implementations) {
+        for (std::size_t size = 0; size <= 70; size++) {
+            std::unique_ptr<char[]> buffer(new char[size]);
+            const char *begin = buffer.get();
+            const char *end = begin + size;
+            std::fill(buffer.get(), buffer.get() + size, 'x');
+            EXPECT_EQ(end, impl.find(begin, end)) << impl.name << " size " << size;
+
+            // Delimiters around 16 and 32 byte boundaries and at both ends of the buffer
+            for (std::size_t pos : {std::size_t(0), std::size_t(15), std::size_t(16), std::size_t(17), std::size_t(31),
+                                    std::size_t(32), std::size_t(33), std::size_t(47), std::size_t(48),
+                                    std::size_t(63), std::size_t(64), size - 1}) {
+                if (pos >= size) {
+                    continue;
+                }
+                for (char delimiter : {' ', '\r'}) {
+                    buffer[pos] = delimiter;
+                    EXPECT_EQ(begin + pos, impl.find(begin, end)) << impl.name << " size " << size << " pos " << pos;
+
+                    // The same delimiter is outside of the range ending right before it
+                    EXPECT_EQ(begin + pos, impl.find(begin, begin + pos)) << impl.name << " pos " << pos;
+                    buffer[pos] = 'x';
+                }
+            }
+        }
+    }
+}
@@ -1,7 +1,12 @@
 #include "gtest/gtest.h"
+#include <chrono>
+#include <cstdint>
+#include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <random>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include <afina/execute/Add.h>
@@ -10,7 +15,22 @@
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/ArtIndex.h"
+#include "storage/BasicCache.h"
+#include "storage/BufferedLRU.h"
+#include "storage/CircularLog.h"
+#include "storage/CompactLRU.h"
+#include "storage/ConcurrentClock.h"
+#include "storage/ConcurrentHashMap.h"
+#include "storage/ExpiryWheel.h"
+#include "storage/OrderedLRU.h"
+#include "storage/ShardedLRU.h"
+#include "storage/SimpleClock.h"
 #include "storage/SimpleLRU.h"
+#include "storage/SwissIndex.h"
+#include "storage/ThreadSafeClock.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
@@ -195,3 +215,1136 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(StorageTest, IndexGrowAndErase) {
+    struct traits {
+        std::size_t Hash(const std::string *const &key) const { return KeyHash(*key); }
+        bool Equal(const std::string *const &slot, const std::string &key) const { return *slot == key; }
+    };
+
+    std::vector<std::string> keys;
+    for (long i = 0; i < 10000; ++i) {
+        keys.push_back("Key " + std::to_string(i));
+    }
+
+    SwissIndex<const std::string *, traits> index;
+    for (auto &key : keys) {
+        EXPECT_TRUE(index.Find(key, KeyHash(key)) == nullptr);
+        index.Insert(&key, KeyHash(key));
+    }
+    EXPECT_EQ(keys.size(), index.Size());
+
+    // Remove every odd key, even ones must survive all tombstones
+    for (size_t i = 1; i < keys.size(); i += 2) {
+        EXPECT_TRUE(index.Erase(keys[i], KeyHash(keys[i])));
+        EXPECT_FALSE(index.Erase(keys[i], KeyHash(keys[i])));
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const std::string *const *slot = index.Find(keys[i], KeyHash(keys[i]));
+        if (i % 2 == 0) {
+            ASSERT_TRUE(slot != nullptr);
+            EXPECT_EQ(&keys[i], *slot);
+        } else {
+            EXPECT_TRUE(slot == nullptr);
+        }
+    }
+
+    // Reinsert removed keys to make index reuse deleted slots
+    for (size_t i = 1; i < keys.size(); i += 2) {
+        index.Insert(&keys[i], KeyHash(keys[i]));
+    }
+    EXPECT_EQ(keys.size(), index.Size());
+    for (auto &key : keys) {
+        EXPECT_TRUE(index.Find(key, KeyHash(key)) != nullptr);
+    }
+}
+
+struct art_item {
+    std::string key;
+};
+
+struct art_traits {
+    const std::string &Key(const art_item *item) const { return item->key; }
+};
+
+TEST(StorageTest, ArtIndexMatchesOrderedMap) {
+    // Short alphabet gives lots of shared prefixes, keys being prefixes of others and long compressed paths
+    std::mt19937 rnd(7);
+    std::vector<std::unique_ptr<art_item>> items;
+    for (int i = 0; i < 5000; i++) {
+        std::string key(rnd() % 3 == 0 ? "user:0000000000:" : "");
+        for (size_t len = 1 + rnd() % 6; len > 0; len--) {
+            key.push_back("ab\xff"[rnd() % 3]);
+        }
+        items.emplace_back(new art_item{key});
+    }
+
+    ArtIndex<art_item, art_traits> index;
+    std::map<std::string, art_item *> expected;
+    for (int step = 0; step < 40000; step++) {
+        art_item *item = items[rnd() % items.size()].get();
+        if (rnd() % 3 == 0) {
+            EXPECT_EQ(expected.erase(item->key) == 1, index.Erase(item->key));
+        } else {
+            index.Insert(item);
+            expected[item->key] = item;
+        }
+        EXPECT_EQ(expected.size(), index.Size());
+    }
+
+    for (auto &item : items) {
+        auto it = expected.find(item->key);
+        EXPECT_EQ(it == expected.end() ? nullptr : it->second, index.Find(item->key));
+    }
+
+    for (std::string prefix : {"", "a", "ab", "user:0000000000:", "user:00", "user:0000000000:b", "c"}) {
+        std::vector<std::string> keys;
+        index.Scan(prefix, [&keys](art_item *item) {
+            keys.push_back(item->key);
+            return true;
+        });
+
+        std::vector<std::string> wanted;
+        for (auto it = expected.lower_bound(prefix); it != expected.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+            wanted.push_back(it->first);
+        }
+        EXPECT_TRUE(keys == wanted) << "prefix '" << prefix << "'";
+    }
+
+    for (auto &entry : expected) {
+        EXPECT_TRUE(index.Erase(entry.first));
+    }
+    EXPECT_EQ(0, index.Size());
+    EXPECT_EQ(0, index.Bytes());
+}
+
+TEST(StorageTest, OrderedScanByPrefix) {
+    OrderedLRU storage(100);
+
+    EXPECT_TRUE(storage.Put("user:2:name", "b"));
+    EXPECT_TRUE(storage.Put("user:1:name", "a"));
+    EXPECT_TRUE(storage.Put("user:1", "x"));
+    EXPECT_TRUE(storage.Put("user:10:name", "c"));
+    EXPECT_TRUE(storage.Put("group:1", "g"));
+    EXPECT_TRUE(storage.Put("user:3", "old", uint32_t(time(nullptr) - 1)));
+
+    std::vector<std::string> keys;
+    auto collect = [&keys](const std::string &key, const Afina::Storage::Value &) {
+        keys.push_back(key);
+        return true;
+    };
+    EXPECT_TRUE(storage.Scan("user:1", collect));
+    EXPECT_TRUE(keys == std::vector<std::string>({"user:1", "user:10:name", "user:1:name"}));
+
+    keys.clear();
+    EXPECT_TRUE(storage.Scan("user:", collect));
+    EXPECT_EQ(4, keys.size());
+
+    // Least recently used keys get evicted as usual
+    EXPECT_TRUE(storage.Put("big", std::string(90, 'v')));
+    std::string value;
+    EXPECT_FALSE(storage.Get("user:2:name", value));
+    keys.clear();
+    EXPECT_TRUE(storage.Scan("", collect));
+    EXPECT_TRUE(keys == std::vector<std::string>({"big"}));
+
+    SimpleLRU unordered;
+    EXPECT_FALSE(unordered.Scan("", collect));
+}
+
+TEST(StorageTest, ShardedPutGetDelete) {
+    const size_t length = 20;
+    ShardedLRU storage(8 * 2 * 1000 * length, 8);
+
+    for (long i = 0; i < 1000; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    for (long i = 0; i < 1000; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+
+        std::string res;
+        EXPECT_TRUE(storage.Get(key, res));
+        EXPECT_TRUE(val == res);
+        EXPECT_FALSE(storage.PutIfAbsent(key, val));
+        EXPECT_TRUE(storage.Delete(key));
+        EXPECT_FALSE(storage.Get(key, res));
+    }
+}
+
+TEST(StorageTest, BackgroundEvictionKeepsHeadroom) {
+    ThreadSafeSimplLRU storage(1000);
+
+    // Each entry is 10 bytes, so size is above the high watermark of 900 bytes. Nothing is evicted by writes
+    for (long i = 0; i < 95; ++i) {
+        EXPECT_TRUE(storage.Put(std::to_string(1000 + i), pad_space("v", 6)));
+    }
+    storage.Start();
+
+    std::map<std::string, std::string> stats;
+    for (int i = 0; i < 1000; i++) {
+        storage.Stats(stats);
+        if (std::stoul(stats["lru_items_bytes"]) <= 800) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    storage.Stop();
+
+    EXPECT_EQ("800", stats["lru_items_bytes"]);
+    EXPECT_EQ("15", stats["lru_background_evicted"]);
+
+    std::string res;
+    EXPECT_FALSE(storage.Get("1014", res));
+    EXPECT_TRUE(storage.Get("1015", res));
+    EXPECT_TRUE(storage.Get("1094", res));
+}
+
+TEST(StorageTest, BufferedReadPromotes) {
+    BufferedLRU storage(3 * 8);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+
+    // Read is applied to the LRU order before next write, so KEY2 is the one to be evicted
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Put("KEY4", "val4"));
+
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val1");
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Get("KEY4", value));
+}
+
+TEST(StorageTest, BufferedConcurrentReadWrite) {
+    const size_t length = 20;
+    BufferedLRU storage(2 * 100 * length);
+
+    for (long i = 0; i < 100; ++i) {
+        storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length));
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&storage, t, length]() {
+            std::string res;
+            for (long i = 0; i < 20000; ++i) {
+                long k = (i * 7 + t) % 200;
+                auto key = pad_space("Key " + std::to_string(k), length);
+                if (t == 0 && i % 10 == 0) {
+                    storage.Put(key, pad_space("Val " + std::to_string(k), length));
+                } else if (storage.Get(key, res)) {
+                    EXPECT_TRUE(res == pad_space("Val " + std::to_string(k), length));
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+// Same scenario for every engine combination
+template <typename Engine> void CheckEngine() {
+    const size_t length = 20;
+    Engine storage(2 * 100 * length);
+
+    std::string res;
+    EXPECT_FALSE(storage.Set("KEY", "val"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY", "val"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY", "other"));
+    EXPECT_TRUE(storage.Set("KEY", "other"));
+    EXPECT_TRUE(storage.Get("KEY", res));
+    EXPECT_TRUE(res == "other");
+    EXPECT_TRUE(storage.Delete("KEY"));
+    EXPECT_FALSE(storage.Delete("KEY"));
+    EXPECT_TRUE(storage.Put("OLD", "val", uint32_t(time(nullptr) - 1)));
+    EXPECT_FALSE(storage.Get("OLD", res));
+
+    for (long i = 0; i < 110; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val " + std::to_string(i), length)));
+    }
+    for (long i = 0; i < 10; ++i) {
+        EXPECT_FALSE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+
+    std::vector<std::string> keys(100);
+    std::vector<Afina::Storage::Value> values(100);
+    for (long i = 0; i < 100; ++i) {
+        keys[i] = pad_space("Key " + std::to_string(i + 10), length);
+    }
+    EXPECT_EQ(100, storage.MultiGet(keys.data(), keys.size(), values.data()));
+    EXPECT_TRUE(*values[99] == pad_space("Val 109", length));
+}
+
+TEST(StorageTest, BasicCacheEngines) {
+    CheckEngine<BasicLRU>();
+    CheckEngine<ThreadSafeBasicLRU>();
+    CheckEngine<BasicClock>();
+    CheckEngine<ThreadSafeBasicClock>();
+    CheckEngine<BasicOrderedLRU>();
+
+    BasicOrderedLRU ordered;
+    EXPECT_TRUE(ordered.Put("b", "1"));
+    EXPECT_TRUE(ordered.Put("a", "2"));
+    std::string keys;
+    EXPECT_TRUE(ordered.Scan("", [&keys](const std::string &key, const Afina::Storage::Value &) {
+        keys += key;
+        return true;
+    }));
+    EXPECT_EQ("ab", keys);
+}
+
+TEST(StorageTest, BasicClockSecondChance) {
+    BasicClock storage(3 * 8);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Put("KEY4", "val4"));
+
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Get("KEY4", value));
+}
+
+TEST(StorageTest, ClockSecondChance) {
+    SimpleClock storage(3 * 8);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY2", "val2"));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+
+    // KEY1 is referenced, so hand skips it and evicts KEY2
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Put("KEY4", "val4"));
+
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val1");
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+    EXPECT_TRUE(storage.Get("KEY4", value));
+}
+
+TEST(StorageTest, ClockMaxTest) {
+    const size_t length = 20;
+    SimpleClock storage(2 * 1000 * length);
+
+    for (long i = 0; i < 1100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    for (long i = 0; i < 100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+
+        std::string res;
+        EXPECT_FALSE(storage.Get(key, res));
+    }
+
+    for (long i = 100; i < 1100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+
+        std::string res;
+        EXPECT_TRUE(storage.Get(key, res));
+        EXPECT_TRUE(val == res);
+        EXPECT_TRUE(storage.Delete(key));
+    }
+}
+
+TEST(StorageTest, ConcurrentMapGrowsUnderLoad) {
+    ConcurrentHashMap<long> map;
+
+    // Stable keys must be visible to readers all the time while writers make the table grow several times
+    for (long i = 0; i < 100; ++i) {
+        map.Update("Stable " + std::to_string(i), [i](const long *, long &value) {
+            value = i;
+            return true;
+        });
+    }
+    size_t buckets = map.Buckets();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; t++) {
+        threads.emplace_back([&map, t]() {
+            for (long i = 0; i < 20000; ++i) {
+                map.Update("Key " + std::to_string(t) + " " + std::to_string(i), [i](const long *, long &value) {
+                    value = i;
+                    return true;
+                });
+            }
+        });
+    }
+    for (int t = 0; t < 2; t++) {
+        threads.emplace_back([&map]() {
+            for (long i = 0; i < 50000; ++i) {
+                long value = -1;
+                long k = i % 100;
+                EXPECT_TRUE(map.Find("Stable " + std::to_string(k), value));
+                EXPECT_EQ(k, value);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(40100, map.Size());
+    EXPECT_LT(buckets, map.Buckets());
+    for (long i = 0; i < 20000; i += 97) {
+        long value = -1;
+        EXPECT_TRUE(map.Find("Key 1 " + std::to_string(i), value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_TRUE(map.Erase("Key 0 0", [](long) { return true; }));
+    EXPECT_FALSE(map.Erase("Key 0 0", [](long) { return true; }));
+    EXPECT_EQ(40099, map.Size());
+}
+
+TEST(StorageTest, ConcurrentClockMaxTest) {
+    const size_t length = 20;
+    ConcurrentClock storage(2 * 1000 * length);
+
+    EXPECT_FALSE(storage.Set("Key", "Val"));
+    EXPECT_TRUE(storage.PutIfAbsent("Key", "Val"));
+    EXPECT_FALSE(storage.PutIfAbsent("Key", "Other"));
+    EXPECT_TRUE(storage.Set("Key", "Other"));
+    EXPECT_TRUE(storage.Put("Expired", "Val", uint32_t(time(nullptr) - 1)));
+
+    std::string res;
+    EXPECT_TRUE(storage.Get("Key", res));
+    EXPECT_TRUE(res == "Other");
+    EXPECT_FALSE(storage.Get("Expired", res));
+    EXPECT_FALSE(storage.Delete("Expired"));
+    EXPECT_TRUE(storage.Delete("Key"));
+
+    for (long i = 0; i < 1100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    // Nothing is referenced, so clock evicts exactly as much as needed
+    size_t found = 0;
+    for (long i = 0; i < 1100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        if (storage.Get(key, res)) {
+            EXPECT_TRUE(res == pad_space("Val " + std::to_string(i), length));
+            found++;
+        }
+    }
+    EXPECT_EQ(1000, found);
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("1000", stats["concurrent_items"]);
+    EXPECT_EQ("100", stats["concurrent_evicted"]);
+}
+
+TEST(StorageTest, TinyLFUScanResistance) {
+    const size_t length = 20;
+    TinyLFU storage(2 * 1000 * length, 10);
+
+    // Make first keys popular
+    std::string res;
+    for (int round = 0; round < 5; ++round) {
+        for (long i = 0; i < 500; ++i) {
+            auto key = pad_space("Key " + std::to_string(i), length);
+            if (!storage.Get(key, res)) {
+                EXPECT_TRUE(storage.Put(key, pad_space("Val " + std::to_string(i), length)));
+            }
+        }
+    }
+
+    // One-hit scan must not flush them. Sketch is probabilistic, so a few of popular keys could lose
+    for (long i = 10000; i < 12000; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+    }
+
+    long survived = 0;
+    for (long i = 0; i < 500; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        if (storage.Get(key, res)) {
+            EXPECT_TRUE(res == pad_space("Val " + std::to_string(i), length));
+            survived++;
+        }
+    }
+    EXPECT_GE(survived, 490);
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_NE("0", stats["tinylfu_rejected"]);
+    EXPECT_EQ(std::to_string(2000 + survived), stats["get_hits"]);
+    EXPECT_EQ(std::to_string(1000 - survived), stats["get_misses"]);
+}
+
+TEST(StorageTest, CircularLogOverwritesOldest) {
+    // Each item takes 16 bytes of header, 7 bytes of key and 41 of value: 40 items fit into the log
+    const std::string val(41, 'v');
+    CircularLog storage(40 * 64);
+
+    std::string res;
+    EXPECT_FALSE(storage.Set("Key 0", "Val"));
+    EXPECT_TRUE(storage.PutIfAbsent("Key 0", "Val"));
+    EXPECT_FALSE(storage.PutIfAbsent("Key 0", "Val"));
+    EXPECT_TRUE(storage.Set("Key 0", "Va0"));
+    EXPECT_TRUE(storage.Get("Key 0", res));
+    EXPECT_TRUE(res == "Va0");
+    EXPECT_TRUE(storage.Delete("Key 0"));
+    EXPECT_FALSE(storage.Get("Key 0", res));
+    EXPECT_TRUE(storage.Put("Expired", "v", uint32_t(time(nullptr) - 1)));
+    EXPECT_FALSE(storage.Get("Expired", res));
+    EXPECT_FALSE(storage.Put("Huge", std::string(40 * 64, 'v')));
+
+    for (long i = 100; i < 200; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), val));
+    }
+
+    // Only the last items survive, but some of them could be dropped from the lossy index
+    size_t found = 0;
+    for (long i = 100; i < 200; ++i) {
+        if (storage.Get("Key " + std::to_string(i), res)) {
+            EXPECT_GE(i, 160);
+            EXPECT_TRUE(res == val);
+            found++;
+        }
+    }
+    EXPECT_LE(found, 40);
+    EXPECT_GE(found, 30);
+}
+
+TEST(StorageTest, CircularLogReappendsHotItems) {
+    const std::string val(41, 'v');
+    CircularLog storage(40 * 64);
+
+    // Hot key is read before it gets to the oldest part of the log, so it is never overwritten
+    std::string res;
+    EXPECT_TRUE(storage.Put("Hot 000", val));
+    for (long i = 100; i < 1000; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), val));
+        if (i % 5 == 0) {
+            EXPECT_TRUE(storage.Get("Hot 000", res));
+        }
+    }
+    EXPECT_TRUE(storage.Get("Hot 000", res));
+    EXPECT_FALSE(storage.Get("Key 100", res));
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_NE("0", stats["log_reappended_items"]);
+}
+
+TEST(StorageTest, CompactMaxTest) {
+    // Budget includes entries headers and slab rounding, so only part of 1000 entries fits
+    const size_t length = 20;
+    CompactLRU storage(2 * 1000 * length);
+
+    for (long i = 0; i < 1100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    for (long i = 0; i < 100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+
+        std::string res;
+        EXPECT_FALSE(storage.Get(key, res));
+    }
+
+    // Value of different size makes entry moved to another slab class
+    for (long i = 1000; i < 1100; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+
+        std::string res;
+        EXPECT_TRUE(storage.Get(key, res));
+        EXPECT_TRUE(val == res);
+        EXPECT_TRUE(storage.Set(key, "v" + std::to_string(i)));
+        EXPECT_TRUE(storage.Get(key, res));
+        EXPECT_TRUE(res == "v" + std::to_string(i));
+    }
+
+    for (long i = 1000; i < 1100; i += 2) {
+        EXPECT_TRUE(storage.Delete(pad_space("Key " + std::to_string(i), length)));
+        EXPECT_FALSE(storage.Delete(pad_space("Key " + std::to_string(i), length)));
+        EXPECT_TRUE(storage.PutIfAbsent(pad_space("Key " + std::to_string(i), length), "new"));
+    }
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_GE(2 * 1000 * length, std::stoul(stats["compact_slab_bytes"]));
+    EXPECT_EQ("0", stats["slab_large_items"]);
+}
+
+TEST(StorageTest, CompactRebalancesClasses) {
+    CompactLRU storage(64 * 1024);
+
+    // Small entries take all the memory first
+    for (long i = 0; i < 2000; ++i) {
+        EXPECT_TRUE(storage.Put("Small " + std::to_string(i), pad_space("v", 20)));
+    }
+
+    // Then sizes shift: pages of the small class are handed over to the big one
+    for (long i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(storage.Put("Big " + std::to_string(i), pad_space("v", 400)));
+    }
+
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_NE("0", stats["slab_moved_pages"]);
+
+    // Big entries evict each other and keep the most fresh ones, most of the memory serves them now
+    std::string res;
+    long found = 0;
+    for (long i = 0; i < 1000; ++i) {
+        found += storage.Get("Big " + std::to_string(i), res);
+    }
+    EXPECT_TRUE(storage.Get("Big 999", res));
+    EXPECT_GT(found * 420, 32 * 1024);
+
+    // Small entry evicts small one only
+    EXPECT_TRUE(storage.Put("Small new", pad_space("v", 20)));
+    EXPECT_TRUE(storage.Get("Big 999", res));
+    EXPECT_TRUE(storage.Get("Big 998", res));
+
+    // Entry moved to another class by overwrite is accounted by its new size
+    CompactLRU moving(64 * 1024);
+    EXPECT_TRUE(moving.Put("k", std::string(10, 'x')));
+    EXPECT_TRUE(moving.Put("k", std::string(1000, 'x')));
+    moving.Stats(stats);
+    EXPECT_EQ("1001", stats["compact_items_bytes"]);
+    EXPECT_TRUE(moving.Put("k", std::string(10, 'x')));
+    moving.Stats(stats);
+    EXPECT_EQ("11", stats["compact_items_bytes"]);
+    EXPECT_TRUE(moving.Delete("k"));
+    moving.Stats(stats);
+    EXPECT_EQ("0", stats["compact_items_bytes"]);
+}
+
+static void CheckUpdate(Afina::Storage &storage) {
+    auto append = [](const std::string &value, std::string &result) {
+        result = value + "x";
+        return true;
+    };
+    EXPECT_FALSE(storage.Update("KEY", append));
+
+    // Updates are never lost, even being done concurrently
+    EXPECT_TRUE(storage.Put("KEY", ""));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&storage, &append]() {
+            for (int i = 0; i < 100; i++) {
+                EXPECT_TRUE(storage.Update("KEY", append));
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY", value));
+    EXPECT_EQ(std::string(400, 'x'), value);
+
+    // Refused update changes nothing
+    EXPECT_FALSE(storage.Update("KEY", [](const std::string &, std::string &) { return false; }));
+    EXPECT_TRUE(storage.Get("KEY", value));
+    EXPECT_EQ(400, value.size());
+}
+
+TEST(StorageTest, UpdateIsAtomic) {
+    ThreadSafeSimplLRU lru(1024);
+    CheckUpdate(lru);
+
+    ShardedLRU sharded(4096, 4);
+    CheckUpdate(sharded);
+
+    BufferedLRU buffered(1024);
+    CheckUpdate(buffered);
+
+    ConcurrentClock concurrent(1024);
+    CheckUpdate(concurrent);
+
+    ThreadSafeBasicLRU basic(1024);
+    CheckUpdate(basic);
+
+    ThreadSafeClock clock(1024);
+    CheckUpdate(clock);
+}
+
+static void CheckAppend(Afina::Storage &storage) {
+    std::string expected = "body";
+    uint64_t version, previous = 0;
+    EXPECT_FALSE(storage.Append("KEY", "tail", version));
+    EXPECT_TRUE(storage.Put("KEY", expected));
+
+    // Enough pieces on both sides to get them merged, each write gives out the new version
+    for (int i = 0; i < 100; i++) {
+        std::string piece = std::to_string(i);
+        if (i % 3 == 0) {
+            EXPECT_TRUE(storage.Prepend("KEY", piece, version));
+            expected = piece + expected;
+        } else {
+            EXPECT_TRUE(storage.Append("KEY", piece, version));
+            expected += piece;
+        }
+        EXPECT_EQ(storage.Versioned(), version != previous);
+        previous = version;
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY", value));
+    EXPECT_EQ(expected, value);
+
+    Afina::Storage::Value current;
+    uint64_t current_version;
+    EXPECT_TRUE(storage.GetVersion("KEY", current, current_version));
+    EXPECT_EQ(version, current_version);
+
+    // Joined value is extended further
+    EXPECT_TRUE(storage.Append("KEY", "!", version));
+    Afina::Storage::Value values[2];
+    std::string keys[2] = {"KEY", "NONE"};
+    EXPECT_EQ(1, storage.MultiGet(keys, 2, values));
+    EXPECT_EQ(expected + "!", *values[0]);
+}
+
+TEST(StorageTest, AppendPrepend) {
+    ThreadSafeSimplLRU lru(4096);
+    CheckAppend(lru);
+
+    ShardedLRU sharded(16384, 4);
+    CheckAppend(sharded);
+
+    BufferedLRU buffered(4096);
+    CheckAppend(buffered);
+
+    ConcurrentClock concurrent(4096);
+    CheckAppend(concurrent);
+
+    SimpleClock clock(4096);
+    CheckAppend(clock);
+
+    ThreadSafeClock mt_clock(4096);
+    CheckAppend(mt_clock);
+
+    ThreadSafeBasicLRU basic(4096);
+    CheckAppend(basic);
+
+    OrderedLRU ordered(4096);
+    CheckAppend(ordered);
+}
+
+TEST(StorageTest, AppendEvictsOldest) {
+    SimpleLRU storage(20);
+    EXPECT_TRUE(storage.Put("a", "0123456"));
+    EXPECT_TRUE(storage.Put("b", "01234"));
+    uint64_t version;
+    EXPECT_TRUE(storage.Append("b", "56", version));
+    EXPECT_EQ(16, storage.Size());
+
+    // Appended chunks count, the oldest key goes away
+    EXPECT_TRUE(storage.Append("b", "789abc", version));
+    EXPECT_FALSE(storage.Contains("a"));
+    EXPECT_EQ(14, storage.Size());
+    EXPECT_FALSE(storage.Prepend("b", std::string(10, 'x'), version));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("b", value));
+    EXPECT_EQ("0123456789abc", value);
+    EXPECT_TRUE(storage.Put("b", "0"));
+    EXPECT_EQ(2, storage.Size());
+}
+
+static void CheckCompareAndSet(Afina::Storage &storage) {
+    Afina::Storage::Value value;
+    uint64_t version = 1;
+    EXPECT_FALSE(storage.CompareAndSet("KEY", "val", 0, version));
+    EXPECT_EQ(0, version);
+
+    EXPECT_TRUE(storage.Put("KEY", "val0"));
+    EXPECT_TRUE(storage.GetVersion("KEY", value, version));
+    EXPECT_EQ("val0", *value);
+    EXPECT_NE(0, version);
+
+    // Only one of the writers having the same version succeeds
+    uint64_t first = version, second = version;
+    EXPECT_TRUE(storage.CompareAndSet("KEY", "val1", 0, first));
+    EXPECT_FALSE(storage.CompareAndSet("KEY", "val2", 0, second));
+    EXPECT_EQ(first, second);
+
+    EXPECT_TRUE(storage.GetVersion("KEY", value, version));
+    EXPECT_EQ("val1", *value);
+    EXPECT_EQ(first, version);
+}
+
+// Counter incremented by concurrent read-modify-cas loops, no increment is lost only if cas is atomic
+static void CheckConcurrentCompareAndSet(Afina::Storage &storage) {
+    EXPECT_TRUE(storage.Put("COUNTER", "0"));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&storage]() {
+            for (int i = 0; i < 200; i++) {
+                for (;;) {
+                    Afina::Storage::Value value;
+                    uint64_t version;
+                    EXPECT_TRUE(storage.GetVersion("COUNTER", value, version));
+                    if (storage.CompareAndSet("COUNTER", std::to_string(std::stoi(*value) + 1), 0, version)) {
+                        break;
+                    }
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("COUNTER", value));
+    EXPECT_EQ("800", value);
+}
+
+TEST(StorageTest, CompareAndSet) {
+    ThreadSafeSimplLRU lru(1024);
+    CheckCompareAndSet(lru);
+
+    ShardedLRU sharded(4096, 4);
+    CheckCompareAndSet(sharded);
+
+    BufferedLRU buffered(1024);
+    CheckCompareAndSet(buffered);
+
+    ConcurrentClock concurrent(1024);
+    CheckCompareAndSet(concurrent);
+
+    ThreadSafeBasicLRU basic(1024);
+    CheckCompareAndSet(basic);
+
+    SimpleClock clock(1024);
+    CheckCompareAndSet(clock);
+
+    ThreadSafeClock mt_clock(1024);
+    CheckCompareAndSet(mt_clock);
+
+    // Writing the same value again gives the new version, so old one is rejected
+    uint64_t version;
+    Afina::Storage::Value value;
+    EXPECT_TRUE(clock.Put("SAME", "val"));
+    EXPECT_TRUE(clock.GetVersion("SAME", value, version));
+    EXPECT_TRUE(clock.Put("SAME", "val"));
+    uint64_t stale = version;
+    EXPECT_FALSE(clock.CompareAndSet("SAME", "new", 0, stale));
+    EXPECT_NE(version, stale);
+}
+
+TEST(StorageTest, CompareAndSetUnversioned) {
+    CompactLRU compact(1024);
+    OrderedLRU ordered(1024);
+    CircularLog log(4096);
+    TinyLFU tiny(1024);
+    for (Afina::Storage *storage : std::vector<Afina::Storage *>{&compact, &ordered, &log, &tiny}) {
+        EXPECT_FALSE(storage->Versioned());
+        EXPECT_TRUE(storage->Put("KEY", "val"));
+
+        Afina::Storage::Value value;
+        uint64_t version = 1;
+        EXPECT_TRUE(storage->GetVersion("KEY", value, version));
+        EXPECT_EQ("val", *value);
+        EXPECT_EQ(0, version);
+
+        EXPECT_FALSE(storage->CompareAndSet("KEY", "new", 0, version));
+        std::string current;
+        EXPECT_TRUE(storage->Get("KEY", current));
+        EXPECT_EQ("val", current);
+    }
+}
+
+TEST(StorageTest, CompareAndSetIsAtomic) {
+    ThreadSafeSimplLRU lru(1024);
+    CheckConcurrentCompareAndSet(lru);
+
+    ShardedLRU sharded(4096, 4);
+    CheckConcurrentCompareAndSet(sharded);
+
+    ConcurrentClock concurrent(1024);
+    CheckConcurrentCompareAndSet(concurrent);
+
+    BufferedLRU buffered(1024);
+    CheckConcurrentCompareAndSet(buffered);
+
+    ThreadSafeBasicLRU basic(1024);
+    CheckConcurrentCompareAndSet(basic);
+
+    ThreadSafeClock clock(1024);
+    CheckConcurrentCompareAndSet(clock);
+}
+
+TEST(StorageTest, TouchChangesExpiration) {
+    SimpleLRU storage(1024);
+    uint32_t now = std::time(nullptr);
+
+    std::string out;
+    EXPECT_FALSE(storage.Touch("KEY1", now + 100));
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", now + 100));
+    EXPECT_TRUE(storage.Put("KEY2", "val2", now + 100));
+    EXPECT_TRUE(storage.Touch("KEY1", now - 1));
+    EXPECT_FALSE(storage.Get("KEY1", out));
+
+    // Value is given back and expiration is gone
+    Afina::Storage::Value value;
+    EXPECT_TRUE(storage.GetAndTouch("KEY2", 0, value));
+    EXPECT_EQ("val2", *value);
+    EXPECT_EQ(0, storage.Expire(now + 1000, 100));
+    EXPECT_TRUE(storage.Get("KEY2", out));
+}
+
+TEST(StorageTest, ExpireOnAccess) {
+    SimpleLRU storage;
+    uint32_t now = std::time(nullptr);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1", now - 1));
+    EXPECT_TRUE(storage.Put("KEY2", "val2", now + 1000));
+    EXPECT_TRUE(storage.Put("KEY3", "val3"));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(storage.Get("KEY3", value));
+
+    // Expired key is absent for all operations
+    EXPECT_TRUE(storage.Put("KEY1", "val1", now - 1));
+    EXPECT_FALSE(storage.Set("KEY1", "val1"));
+    EXPECT_TRUE(storage.Put("KEY1", "val1", now - 1));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY1", "new"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "new");
+
+    // Set without expiration time keeps the existing one
+    EXPECT_TRUE(storage.Set("KEY2", "new"));
+    while (storage.Expire(now + 1000, 100) != 0) {
+    }
+    EXPECT_FALSE(storage.Get("KEY2", value));
+    EXPECT_EQ(15, storage.Size());
+}
+
+TEST(StorageTest, ExpireSweepSlices) {
+    SimpleLRU storage(1024 * 1024);
+    uint32_t now = std::time(nullptr);
+
+    for (long i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "Val", now + 10 + i % 100000));
+    }
+    EXPECT_TRUE(storage.Put("Key", "Val"));
+
+    // Nothing is expired yet
+    EXPECT_EQ(0, storage.Expire(now, 100));
+
+    std::size_t removed = 0;
+    for (std::size_t done = 1; done != 0;) {
+        done = storage.Expire(now + 2000, 100);
+        EXPECT_LE(done, 100);
+        removed += done;
+    }
+    EXPECT_GE(removed, 1000);
+    EXPECT_EQ(std::string("Key").size() + 3, storage.Size());
+}
+
+namespace {
+
+struct wheel_item {
+    uint32_t expire;
+    uint16_t wheel_slot;
+    wheel_item *wheel_prev;
+    wheel_item *wheel_next;
+};
+
+} // namespace
+
+TEST(StorageTest, ExpiryWheelPrecision) {
+    const uint32_t start = 1000000;
+    ExpiryWheel<wheel_item> wheel(start);
+
+    std::mt19937 rng(42);
+    std::vector<wheel_item> items(5000);
+    for (auto &item : items) {
+        item.expire = start + 1 + rng() % 300000;
+        item.wheel_slot = ExpiryWheel<wheel_item>::kNone;
+        wheel.Add(&item);
+    }
+
+    // Every item expires exactly at its time
+    std::size_t expired = 0;
+    for (uint32_t now = start; now < start + 301000; now += 1 + rng() % 500) {
+        wheel.Advance(now, SIZE_MAX, [&](wheel_item *item) {
+            EXPECT_LE(item->expire, now);
+            EXPECT_EQ(ExpiryWheel<wheel_item>::kNone, item->wheel_slot);
+            expired++;
+        });
+        for (auto &item : items) {
+            if (item.wheel_slot != ExpiryWheel<wheel_item>::kNone) {
+                ASSERT_GT(item.expire, now);
+            }
+        }
+    }
+    EXPECT_EQ(items.size(), expired);
+    EXPECT_EQ(0, wheel.Size());
+}
+
+TEST(StorageTest, ExpiryWheelIdleGap) {
+    const uint32_t start = 1000000;
+    ExpiryWheel<wheel_item> wheel(start);
+
+    wheel_item item;
+    item.expire = start + 100000;
+    item.wheel_slot = ExpiryWheel<wheel_item>::kNone;
+    wheel.Add(&item);
+
+    // Long gap is walked in slices of the given budget
+    std::size_t expired = 0, calls = 0;
+    for (std::size_t steps = 1; steps != 0; calls++) {
+        steps = wheel.Advance(start + 200000, 16, [&](wheel_item *item) { expired++; });
+        EXPECT_LE(steps, 16);
+        if (calls == 0) {
+            EXPECT_EQ(0, expired);
+        }
+    }
+    EXPECT_EQ(1, expired);
+    EXPECT_GT(calls, 100000 / 16);
+    EXPECT_EQ(0, wheel.Size());
+}
+
+static void CheckMultiGet(Afina::Storage &storage) {
+    std::vector<std::string> keys;
+    for (long i = 0; i < 200; ++i) {
+        keys.push_back("Key " + std::to_string(i));
+        if (i % 3 != 0) {
+            EXPECT_TRUE(storage.Put(keys.back(), "Val " + std::to_string(i)));
+        }
+    }
+    keys.push_back("Key 1");
+
+    std::vector<Afina::Storage::Value> values(keys.size());
+    EXPECT_EQ(134, storage.MultiGet(keys.data(), keys.size(), values.data()));
+
+    for (long i = 0; i < 200; ++i) {
+        EXPECT_EQ(i % 3 != 0, bool(values[i]));
+        if (values[i]) {
+            EXPECT_EQ("Val " + std::to_string(i), *values[i]);
+        }
+    }
+    ASSERT_TRUE(bool(values[200]));
+    EXPECT_EQ("Val 1", *values[200]);
+
+    // Same batch through key descriptors
+    std::vector<Afina::Key> refs;
+    for (auto &key : keys) {
+        refs.emplace_back(key.data(), key.size());
+    }
+    EXPECT_EQ(134, storage.MultiGet(refs.data(), refs.size(), values.data()));
+    EXPECT_FALSE(bool(values[0]));
+    ASSERT_TRUE(bool(values[200]));
+    EXPECT_EQ("Val 1", *values[200]);
+}
+
+TEST(StorageTest, MultiGet) {
+    SimpleLRU simple(1024 * 1024);
+    CheckMultiGet(simple);
+
+    ShardedLRU sharded(1024 * 1024, 8);
+    CheckMultiGet(sharded);
+
+    BufferedLRU buffered(1024 * 1024);
+    CheckMultiGet(buffered);
+
+    SimpleClock clock(1024 * 1024);
+    CheckMultiGet(clock);
+}
+
+TEST(StorageTest, KeyDescriptor) {
+    // Descriptor could refer to any bytes, for example to the middle of network buffer
+    const char buffer[] = "get some_key_longer_than_eight_bytes\r\n";
+    Afina::Key key(buffer + 4, 32);
+    EXPECT_EQ(KeyHash(std::string(buffer + 4, 32)), key.hash);
+    EXPECT_NE(KeyHash(std::string(buffer + 4, 31)), key.hash);
+    EXPECT_TRUE(key == "some_key_longer_than_eight_bytes");
+
+    ShardedLRU storage(1024, 4);
+    Afina::Storage::Value value;
+    EXPECT_FALSE(storage.Get(key, value));
+    EXPECT_TRUE(storage.Put(key, "value", 0));
+    EXPECT_TRUE(storage.Get(key, value));
+    EXPECT_EQ("value", *value);
+
+    std::string copy;
+    EXPECT_TRUE(storage.Get(key.str(), copy));
+    EXPECT_EQ("value", copy);
+}
+
+TEST(StorageTest, ShardedBudget) {
+    // Item st_lru stores with the same budget fits the shard
+    ShardedLRU storage(1024, 4);
+    EXPECT_TRUE(storage.Put("KEY", std::string(100, 'x')));
+
+    // Shards smaller than the minimum are refused
+    EXPECT_THROW(ShardedLRU(1024, 16), std::invalid_argument);
+    EXPECT_THROW(ShardedLRU(1024, 0), std::invalid_argument);
+    EXPECT_NO_THROW(ShardedLRU(16 * ShardedLRU::kMinShardSize, 16));
+}
+
+TEST(StorageTest, ShardedStartsShards) {
+    ShardedLRU storage(4096, 4);
+    for (long i = 0; i < 400; ++i) {
+        EXPECT_TRUE(storage.Put(std::to_string(1000 + i), pad_space("v", 11)));
+    }
+
+    // Counters of shards are summed up
+    std::map<std::string, std::string> stats;
+    storage.Stats(stats);
+    EXPECT_EQ("4096", stats["lru_limit_bytes"]);
+    EXPECT_EQ("4", stats["sharded_shards"]);
+    EXPECT_GT(std::stoul(stats["lru_items_bytes"]), 4 * 820);
+
+    // Every shard gets its background evictor, all of them go down to the low watermark
+    storage.Start();
+    for (int i = 0; i < 1000; i++) {
+        storage.Stats(stats);
+        if (std::stoul(stats["lru_items_bytes"]) <= 4 * 820) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    storage.Stop();
+
+    EXPECT_LE(std::stoul(stats["lru_items_bytes"]), 4 * 820);
+    EXPECT_NE("0", stats["lru_background_evicted"]);
+}
+
+TEST(StorageTest, SharedValueOutlivesUpdate) {
+    ShardedLRU storage(1024, 4);
+
+    Afina::Storage::Value value;
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.Get("KEY1", value));
+
+    // Handle keeps the old buffer, storage gets the new one
+    EXPECT_TRUE(storage.Put("KEY1", "val2"));
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_EQ("val1", *value);
+}